@@ -0,0 +1,27 @@
+#ifndef ACTIONREPEAT_H
+#define ACTIONREPEAT_H
+
+#define REPEAT_DEFAULT_DELAY 400.0f // ms held before auto repeat starts
+#define REPEAT_DEFAULT_INTERVAL 120.0f // ms between repeats
+#define REPEAT_DEFAULT_DEBOUNCE 40.0f // ms a new press is ignored after the last one
+
+namespace Engine {
+	// Turns the held state of an action into discrete triggers using the frame
+	// clock: once on press, then every interval after the initial delay.
+	// Presses arriving within the debounce time of the last trigger are ignored.
+	class ActionRepeat
+	{
+	public:
+		// An interval of 0 disables auto repeat
+		ActionRepeat(float delay = REPEAT_DEFAULT_DELAY, float interval = REPEAT_DEFAULT_INTERVAL, float debounce = REPEAT_DEFAULT_DEBOUNCE);
+		// Returns true when the action should fire this frame
+		bool Update(bool down, float deltaTime);
+		void Reset();
+
+	private:
+		float delay, interval, debounce;
+		float heldTime = 0, nextRepeat = 0, sinceTrigger = 0;
+		bool held = false;
+	};
+}
+#endif
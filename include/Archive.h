@@ -0,0 +1,74 @@
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+
+using namespace std;
+
+#define ARCHIVE_NAME "assets.pak"
+#define ARCHIVE_MAGIC 0x4B504856 // "VHPK"
+#define ARCHIVE_VERSION 1
+#define ARCHIVE_NAME_LENGTH 64
+// Blobs start on this boundary so they can be handed to the driver as they are
+#define ARCHIVE_ALIGNMENT 16
+// Largest image or atlas side an entry may claim
+#define ARCHIVE_MAX_DIMENSION 16384
+
+namespace Engine {
+	// FONT_SDF holds a distance field atlas in the Font::WriteSDF layout
+	enum class ArchiveEntryType : uint32_t { RAW, IMAGE_RGBA, FONT_ATLAS, SHADER, AUDIO, FONT_SDF };
+
+	struct ArchiveHeader {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t entryCount;
+		uint32_t reserved;
+		uint64_t indexOffset;
+	};
+
+	struct ArchiveEntry {
+		char name[ARCHIVE_NAME_LENGTH];
+		ArchiveEntryType type;
+		uint32_t width, height; // Images and font atlases
+		uint32_t param; // Font pixel size
+		uint64_t offset, size;
+	};
+
+	// Serialised glyph of a FONT_ATLAS entry, followed by the width * height atlas pixels
+	struct ArchiveGlyph {
+		int32_t sizeX, sizeY, bearingX, bearingY;
+		uint32_t advance;
+		float uv[4];
+	};
+
+	// Read only view of a packed asset archive, the whole file is memory mapped
+	// and entries point straight into the mapping.
+	class Archive
+	{
+	public:
+		Archive();
+		~Archive();
+		bool Open(const string& path);
+		void Close();
+		bool IsOpen() const { return data != nullptr; }
+		// nullptr if there is no such entry
+		const ArchiveEntry* Find(const string& name) const;
+		const unsigned char* GetData(const ArchiveEntry* entry) const { return data + entry->offset; }
+		// Name of a pre-rasterised font atlas entry
+		static string FontEntryName(const string& fontPath, unsigned int pixelSize);
+		// Name of the distance field atlas entry of a font
+		static string SDFFontEntryName(const string& fontPath);
+
+	private:
+		const unsigned char* data = nullptr;
+		size_t size = 0;
+		unordered_map<string, const ArchiveEntry*> entries;
+#ifdef _WIN32
+		void* file = nullptr;
+		void* mapping = nullptr;
+#endif
+	};
+}
+#endif
@@ -0,0 +1,88 @@
+#ifndef ASSETMANAGER_H
+#define ASSETMANAGER_H
+
+#include <GL/glew.h>
+#include <SDL/SDL_mixer.h>
+#include <string>
+#include <deque>
+#include <future>
+#include <memory>
+#include <GLM/glm.hpp>
+
+#include "ThreadPool.h"
+#include "Font.h"
+#include "Archive.h"
+
+using namespace std;
+using namespace glm;
+
+// Bytes of texture data handed to the driver per frame at most
+#define ASSET_UPLOAD_BUDGET (4 * 1024 * 1024)
+
+namespace Engine {
+	// Decoded RGBA pixels
+	struct Image {
+		int width = 0, height = 0;
+		const unsigned char* pixels = nullptr;
+		// False when the pixels point into the archive mapping
+		bool owned = true;
+		~Image();
+	};
+
+	// Decoded audio, SDL_mixer errors are per thread so the worker's message travels along
+	template<class T>
+	struct AudioAsset {
+		// nullptr if the file could not be decoded
+		T* asset = nullptr;
+		string error;
+	};
+
+	// Decodes images, fonts and audio on the worker pool. The main thread only
+	// uploads: textures go through pixel buffer objects, a few per frame.
+	// Assets found in the packed archive are used from it directly, anything
+	// else falls back to the loose file of the same name.
+	class AssetManager
+	{
+	public:
+		AssetManager();
+		~AssetManager();
+		// Returns false if there is no usable archive, loose files are used then
+		bool OpenArchive(const string& path);
+		// Reads a text asset (shader source), from the archive if it has it
+		// unless the loose file should win, as when hot reloading
+		bool ReadText(const string& path, string& text, bool preferLoose = false) const;
+		// The future holds nullptr if the file could not be decoded
+		shared_future<shared_ptr<Image>> LoadImage(const string& path);
+		shared_future<shared_ptr<FontBitmap>> LoadFont(const string& path, unsigned int pixelSize);
+		// Distance field atlas usable at every size, generated once and then read from the font cache
+		shared_future<shared_ptr<FontBitmap>> LoadSDFFont(const string& path);
+		// Needs the audio device to be open
+		shared_future<AudioAsset<Mix_Music>> LoadMusic(const string& path);
+		// Decodes the whole file to PCM in the device format, needs the audio device to be open
+		shared_future<AudioAsset<Mix_Chunk>> LoadSound(const string& path);
+		// Copies the image into the texture at offset over the next frames, the texture storage must exist
+		shared_future<void> UploadTexture(shared_ptr<Image> image, GLuint texture, ivec2 offset);
+		// Advances the pending uploads, called once per frame on the GL thread
+		void Update();
+		bool HasPendingUploads() const { return !uploads.empty(); }
+
+	private:
+		enum class UploadStage { QUEUED, COPYING };
+		struct Upload {
+			shared_ptr<Image> image;
+			GLuint texture;
+			ivec2 offset;
+			GLuint pbo;
+			UploadStage stage;
+			future<void> copy;
+			shared_ptr<promise<void>> done;
+		};
+		deque<Upload> uploads;
+		Archive archive;
+		// Entries whose size disagrees with their dimensions are loaded from the loose file instead
+		static bool IsValidEntry(const ArchiveEntry* entry, uint64_t expectedSize);
+		template<class T>
+		static AudioAsset<T> MakeAudioAsset(T* asset);
+	};
+}
+#endif
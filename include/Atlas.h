@@ -0,0 +1,27 @@
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include <GLM/glm.hpp>
+
+using namespace glm;
+
+namespace Engine {
+	// Packs rectangles into a fixed-width texture using shelves: items are placed
+	// left to right and a new shelf is opened below when the current one is full.
+	class AtlasPacker
+	{
+	public:
+		AtlasPacker(int width, int height, int padding = 1);
+		// Returns false if the rectangle does not fit anymore
+		bool Pack(int w, int h, ivec2& position);
+		int GetWidth() const { return width; }
+		int GetHeight() const { return height; }
+		// Height actually covered by the shelves, useful to trim the atlas
+		int GetUsedHeight() const { return shelfY + shelfHeight; }
+
+	private:
+		int width, height, padding;
+		int shelfX = 0, shelfY = 0, shelfHeight = 0;
+	};
+}
+#endif
@@ -0,0 +1,56 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include <SDL/SDL.h>
+#include <SDL/SDL_mixer.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#define AUDIO_DEFAULT_RATE 44100
+// 512 samples is about 12 ms at 44.1 kHz
+#define AUDIO_DEFAULT_BUFFER 512
+#define AUDIO_DEFAULT_VOICES 16
+
+typedef int SoundID;
+#define INVALID_SOUND -1
+
+namespace Engine {
+	// Sound effects are decoded once into PCM chunks and played on a fixed pool
+	// of mixer channels. When every voice is busy the lowest priority, oldest one
+	// is stolen. Music has its own stream and is never interrupted by effects.
+	class Audio
+	{
+	public:
+		Audio();
+		~Audio();
+		bool Init(int rate, int bufferSize, int voices, string& error);
+		void DeInit();
+		// Takes ownership of a decoded chunk
+		SoundID AddSound(Mix_Chunk* chunk);
+		// Returns the voice playing the sound, -1 if every voice is busy with something more important
+		int Play(SoundID sound, int priority = 0, int volume = MIX_MAX_VOLUME);
+		void StopAll();
+		// Takes ownership of the music
+		void SetMusic(Mix_Music* music);
+		bool HasMusic() const { return music != nullptr; }
+		void PlayMusic(int loops = -1);
+		void PauseMusic();
+		void ResumeMusic();
+		void StopMusic();
+
+	private:
+		struct Voice {
+			SoundID sound;
+			int priority;
+			Uint64 startedAt;
+		};
+		bool initialized = false;
+		vector<Mix_Chunk*> sounds;
+		vector<Voice> voices;
+		Uint64 playCounter = 0;
+		Mix_Music* music = nullptr;
+	};
+}
+#endif
@@ -0,0 +1,95 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <cstdint>
+#include <cstring>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// One 64 bit word per row and colour, so boards can be up to 64 cells wide
+#define BOARD_MAX_WIDTH 64
+#define BOARD_MAX_HEIGHT 32
+// Colours are padded to this many so SIMD code can always process full vectors
+#define BOARD_MAX_COLOURS 8
+#define BOARD_DEFAULT_WIDTH 8
+#define BOARD_DEFAULT_HEIGHT 8
+#define BOARD_DEFAULT_COLOURS 6
+#define BOARD_EMPTY 0xFF
+
+namespace Engine {
+	// Index of the lowest set bit, value must not be zero
+	inline int LowestBit(uint64_t value)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward64(&index, value);
+		return (int)index;
+#else
+		return __builtin_ctzll(value);
+#endif
+	}
+
+	inline unsigned int PopCount(uint64_t value)
+	{
+#ifdef _MSC_VER
+		unsigned int count = 0;
+		for (; value; count++) {
+			value &= value - 1;
+		}
+		return count;
+#else
+		return (unsigned int)__builtin_popcountll(value);
+#endif
+	}
+
+	// One bit per cell, bit x of rows[y] is cell (x, y)
+	struct MatchMask {
+		uint64_t rows[BOARD_MAX_HEIGHT];
+		void Clear() { memset(rows, 0, sizeof(rows)); }
+		bool Test(int x, int y) const { return (rows[y] >> x) & 1; }
+		unsigned int Count(int height) const;
+	};
+
+	// Match-3 grid stored as one bitboard per virus colour. Row 0 is the top,
+	// pieces fall towards higher rows.
+	class Board
+	{
+	public:
+		Board(int width = BOARD_DEFAULT_WIDTH, int height = BOARD_DEFAULT_HEIGHT, int colours = BOARD_DEFAULT_COLOURS);
+		// Also empties the board
+		void Resize(int width, int height, int colours);
+		int GetWidth() const { return width; }
+		int GetHeight() const { return height; }
+		int GetColourCount() const { return colours; }
+		// Bits of the cells inside the board, for one row
+		uint64_t GetRowMask() const { return rowMask; }
+		uint8_t Get(int x, int y) const { return cells[y][x]; }
+		void Set(int x, int y, uint8_t colour);
+		void Swap(int x1, int y1, int x2, int y2);
+		void Clear();
+		// Cells of one colour in row y
+		uint64_t GetRow(int y, int colour) const { return bits[y][colour]; }
+		// Cells holding any colour in row y
+		uint64_t GetOccupied(int y) const;
+		// Marks every cell that is part of a horizontal or vertical run of 3 or
+		// more, returns true if there is any. Uses the widest SIMD available.
+		bool FindMatches(MatchMask& matches) const;
+		// Only looks for runs that touch rows [firstRow, lastRow), vertical runs are
+		// further limited to the given columns. Enough after a change to a settled board.
+		bool FindMatches(MatchMask& matches, int firstRow, int lastRow, uint64_t columns) const;
+		// Same result without SIMD, one colour at a time
+		bool FindMatchesScalar(MatchMask& matches) const;
+
+	private:
+		// Horizontal runs and vertical run starts of rows [first, last), all colours merged
+		void ScanRowsScalar(int first, int last, uint64_t* horizontal, uint64_t* vertical) const;
+		void ScanRowsSIMD(int first, int last, uint64_t* horizontal, uint64_t* vertical) const;
+		bool ExpandMatches(const uint64_t* horizontal, const uint64_t* vertical, MatchMask& matches) const;
+		alignas(32) uint64_t bits[BOARD_MAX_HEIGHT][BOARD_MAX_COLOURS];
+		uint8_t cells[BOARD_MAX_HEIGHT][BOARD_MAX_WIDTH];
+		int width, height, colours;
+		uint64_t rowMask;
+	};
+}
+#endif
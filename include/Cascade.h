@@ -0,0 +1,55 @@
+#ifndef CASCADE_H
+#define CASCADE_H
+
+#include <vector>
+#include <cstdint>
+
+#include "Board.h"
+#include "Random.h"
+
+using namespace std;
+
+// Stops a board that keeps refilling into matches from looping forever
+#define CASCADE_MAX_STEPS 64
+
+namespace Engine {
+	enum CascadeEventType : uint8_t { CASCADE_CLEARED, CASCADE_FELL, CASCADE_SPAWNED };
+
+	// For FELL fromY is the row the piece left, for SPAWNED it is the row above the
+	// board it drops in from (negative), for CLEARED it equals y
+	struct CascadeEvent {
+		CascadeEventType type;
+		uint8_t step;
+		uint8_t colour;
+		uint8_t x;
+		int8_t y;
+		int8_t fromY;
+	};
+
+	// Clears matches, lets columns fall and refills them until the board settles.
+	// Only the area a step changed is scanned again on the next step.
+	class CascadeResolver
+	{
+	public:
+		CascadeResolver();
+		// After swapping two cells of a settled board, returns the number of steps
+		int ResolveSwap(Board& board, Random& random, int x1, int y1, int x2, int y2);
+		// Looks at the whole board, for freshly generated or edited boards
+		int ResolveAll(Board& board, Random& random);
+		// Only runs touching rows [firstRow, lastRow) and vertical runs in columns are considered at first
+		int Resolve(Board& board, Random& random, int firstRow, int lastRow, uint64_t columns);
+		// Events of the last Resolve, in order, grouped by step
+		const vector<CascadeEvent>& GetEvents() const { return events; }
+		unsigned int GetClearedCount() const { return cleared; }
+
+	private:
+		// Returns the lowest cleared row of each column in lowest, -1 for untouched columns
+		void ClearMatches(Board& board, const MatchMask& matches, int step, int* lowest);
+		// Compacts the touched columns downwards and refills them from the top.
+		// Returns the dirty columns and the number of dirty rows from the top.
+		uint64_t ApplyGravity(Board& board, Random& random, const int* lowest, int step, int& lastRow);
+		vector<CascadeEvent> events;
+		unsigned int cleared;
+	};
+}
+#endif
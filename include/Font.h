@@ -0,0 +1,81 @@
+#ifndef FONT_H
+#define FONT_H
+
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+using namespace std;
+using namespace glm;
+
+#define FONT_NUM_GLYPHS 128
+#define FONT_ATLAS_WIDTH 512
+// Signed distance field fonts are stored at this size and drawn at any scale
+#define FONT_SDF_SIZE 48
+// Pixels at FONT_SDF_SIZE the field reaches either side of the outline, bounds outline and glow width
+#define FONT_SDF_SPREAD 6
+// Glyphs are rendered this many times larger to measure the distances
+#define FONT_SDF_OVERSAMPLE 4
+#define FONT_CACHE_DIR "fontcache"
+#define FONT_CACHE_MAGIC 0x46534856 // "VHSF"
+#define FONT_CACHE_VERSION 1
+
+namespace Engine {
+	struct Glyph {
+		ivec2 Size; // Size of glyph
+		ivec2 Bearing; // Offset from baseline to left/top of glyph
+		GLuint Advance; // Offset to advance to next glyph, in pixels
+		vec4 UV; // Top left and bottom right texture coords inside the atlas
+	};
+
+	// CPU side of a font: every glyph rasterised into one single channel atlas
+	struct FontBitmap {
+		int width = 0, height = 0;
+		vector<unsigned char> pixels;
+		Glyph glyphs[FONT_NUM_GLYPHS];
+		// Bearing of 'H', used to align every glyph on the same top line
+		int capHeight = 0;
+		// Size the glyph metrics are in
+		unsigned int pixelSize = 0;
+		// Pixels hold distances to the outline, 0.5 on the edge, instead of coverage
+		bool sdf = false;
+	};
+
+	class Font
+	{
+	public:
+		Font();
+		~Font();
+		// Rasterises the ASCII range of a font file, does not touch OpenGL
+		static bool Rasterize(const char* fontPath, unsigned int pixelSize, FontBitmap& bitmap, string& error);
+		// Same for a signed distance field atlas with spread pixels of range around
+		// each glyph, which stays sharp at any scale. Slow, use LoadSDF
+		static bool RasterizeSDF(const char* fontPath, unsigned int pixelSize, unsigned int spread, FontBitmap& bitmap, string& error);
+		// RasterizeSDF at FONT_SDF_SIZE, cached in FONT_CACHE_DIR so only the first run pays for it
+		static bool LoadSDF(const char* fontPath, FontBitmap& bitmap, string& error);
+		// Serialised distance field atlas, as cached on disk: header, glyphs, then the pixels.
+		// ReadSDF rejects anything whose size does not match a valid atlas
+		static bool ReadSDF(const unsigned char* data, size_t size, FontBitmap& bitmap, uint64_t& key);
+		static void WriteSDF(const FontBitmap& bitmap, uint64_t key, vector<unsigned char>& data);
+		// Identifies the atlas LoadSDF makes from a font file
+		static uint64_t MakeSDFKey(const void* fontData, size_t size);
+		// Creates the atlas texture, must be called on the thread owning the GL context
+		void Upload(const FontBitmap& bitmap);
+		bool Load(const char* fontPath, unsigned int pixelSize, string& error);
+		const Glyph& GetGlyph(unsigned char c) const { return glyphs[c & (FONT_NUM_GLYPHS - 1)]; }
+		GLuint GetTexture() const { return texture; }
+		int GetCapHeight() const { return capHeight; }
+		unsigned int GetPixelSize() const { return pixelSize; }
+		bool IsSDF() const { return sdf; }
+
+	private:
+		Glyph glyphs[FONT_NUM_GLYPHS];
+		GLuint texture = 0;
+		int capHeight = 0;
+		unsigned int pixelSize = 0;
+		bool sdf = false;
+	};
+}
+#endif
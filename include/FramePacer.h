@@ -0,0 +1,45 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <SDL/SDL.h>
+
+// Budget left for spinning after the sleep. SDL_Delay takes whole milliseconds,
+// so the sleep is rounded to the nearest one and the spin lasts 0.5 to 1.5 ms,
+// less whatever SDL_Delay oversleeps. A shorter spin would trade a busy
+// core for missed deadlines whenever the scheduler wakes us late.
+#define FRAMEPACER_SPIN_THRESHOLD 1.0 // ms
+
+namespace Engine {
+	// Paces frames with the high resolution performance counter. Only the part of
+	// the frame budget that is left is waited for, sleeping first and spinning at
+	// the end, and frame time statistics are gathered along the way.
+	class FramePacer
+	{
+	public:
+		FramePacer();
+		~FramePacer();
+		// 0 means no limit
+		void Init(unsigned int targetFrameRate);
+		// Starts a frame, returns the time since the previous one in ms
+		double BeginFrame();
+		// Waits until the frame budget is used up
+		void EndFrame();
+		// Milliseconds since Init
+		double Now() const;
+		double GetTargetFrameTime() const { return targetFrameTime; }
+		// Frame time statistics since the last ResetStats, in ms
+		double GetFrameTimeMean() const { return mean; }
+		double GetFrameTimeVariance() const { return sampleCount > 1 ? m2 / (sampleCount - 1) : 0.0; }
+		double GetFrameTimeMax() const { return maxFrameTime; }
+		unsigned int GetSampleCount() const { return sampleCount; }
+		void ResetStats();
+
+	private:
+		Uint64 frequency = 1, start = 0, lastFrame = 0;
+		double targetFrameTime = 0, deadline = 0;
+		// Running mean and variance (Welford)
+		unsigned int sampleCount = 0;
+		double mean = 0, m2 = 0, maxFrameTime = 0;
+	};
+}
+#endif
@@ -8,63 +8,208 @@
 #include <sstream>
 #include <iostream>
 #include <unordered_map>
+#include <vector>
+#include <memory>
+#include <bitset>
+#include <functional>
+#include <chrono>
 #include <GLM/glm.hpp>
 #include <GLM/gtc/matrix_transform.hpp>
 #include <GLM/gtc/type_ptr.hpp>
 #include <glm/gtx/vector_angle.hpp>
 
+#include "Shader.h"
+#include "ProgramCache.h"
+#include "ShaderWatcher.h"
+#include "FramePacer.h"
+#include "Profiler.h"
+#include "AssetManager.h"
+#include "ThreadPool.h"
+#include "Random.h"
+#include "Replay.h"
+#include "RenderQueue.h"
+
 using namespace std;
 using namespace glm;
 
 enum class State { RUNNING, EXIT };
+
+// Input actions are dense indices into the key state bitsets
+#define MAX_ACTIONS 64
+typedef unsigned int ActionID;
+#define INVALID_ACTION ((ActionID)-1)
+// Most fixed updates run per frame before the simulation gives up catching up
+#define MAX_FIXED_STEPS 8
+
 enum class WindowFlag { WINDOWED, FULLSCREEN, EXCLUSIVE_FULLSCREEN, BORDERLESS };
 
 namespace Engine {
+	// One measured frame of RunOffscreen
+	struct OffscreenFrame {
+		// Update and Render on the CPU, then waiting for the GL to finish the frame
+		float cpuMs, finishMs;
+		FrameCounters counters;
+	};
+
 	class Game
 	{
 	public:
 		Game();
-		~Game();
+		virtual ~Game();
 		void Start(string title, unsigned int width, unsigned int height, bool vsync, WindowFlag windowFlag, unsigned int targetFrameRate, float timeScale);
+		// Simulation only: no window, GL, audio or frame limiting. Calls InitHeadless()
+		// and then advances by deltaTime per frame (or the recorded delta when replaying)
+		// until frames have run, the replay ends or Quit() is called. Returns false
+		// without running if InitHeadless() failed.
+		bool RunHeadless(unsigned int frames, float deltaTime);
+		// Runs count games made by create(index) headless, in parallel on the pool.
+		// finished(index, game) is called on the worker before the game is destroyed,
+		// for the games that ran. Returns how many failed to start.
+		static unsigned int RunHeadlessBatch(unsigned int count, unsigned int frames, float deltaTime, function<unique_ptr<Game>(unsigned int)> create,
+			function<void(unsigned int, Game&)> finished, ThreadPool& pool = ThreadPool::GetDefault());
+		// Renders into a framebuffer object of an offscreen context, for benchmarks on
+		// machines without a display or GPU. Frames run as fast as possible with a
+		// fixed deltaTime after warmupMs of real time for the assets to load. The last
+		// frame is written to imagePath as a PPM unless it is empty. Defined in
+		// OffscreenRunner.cpp, only built where EGL or OSMesa is available.
+		void RunOffscreen(unsigned int width, unsigned int height, unsigned int frames, float deltaTime, float warmupMs,
+			vector<OffscreenFrame>& results, const string& imagePath = "");
+		bool IsHeadless() const { return headless; }
+		// Logs every frame delta and mapped input of the next run to path and
+		// seeds GetRandom() with seed. Call before Start or RunHeadless.
+		bool StartRecording(const string& path, uint64_t seed);
+		// Plays a recording back in place of the clock and the real input, with
+		// the recorded seed. The run ends with the log, headless runs as fast as possible.
+		bool StartReplay(const string& path);
+		bool IsReplaying() const { return replay.IsPlaying(); }
+		unsigned int GetFrameCount() const { return frameCount; }
 		// Input Handling
 		void PressKey(unsigned int keyID);
 		void ReleaseKey(unsigned int keyID);
 		void SetMouseCoords(float x, float y);
 		// Returns true if the key is held down
-		bool IsKeyDown(string name);
+		bool IsKeyDown(ActionID action) const { return action < MAX_ACTIONS && _keyState.test(action); }
 		// Returns true if the key was just pressed
-		bool IsKeyUp(string name);
+		bool IsKeyUp(ActionID action) const { return IsKeyDown(action) && !WasKeyDown(action); }
 		// getters
 		vec2 GetMouseCoords() const { return _mouseCoords; }
-		// Returns true if the key is held down
-		bool WasKeyDown(string name);
-		void InputMapping(string mappingName, unsigned int keyId);
+		// Returns true if the key was held down last frame
+		bool WasKeyDown(ActionID action) const { return action < MAX_ACTIONS && _previousKeyState.test(action); }
+		// Maps a key to an action, keys mapped to the same name share the action
+		ActionID InputMapping(const string& mappingName, unsigned int keyId);
+		// Slower by name lookups, prefer keeping the ActionID returned by InputMapping
+		ActionID GetAction(const string& mappingName) const;
+		bool IsKeyDown(const string& name) const { return IsKeyDown(GetAction(name)); }
+		bool IsKeyUp(const string& name) const { return IsKeyUp(GetAction(name)); }
+		bool WasKeyDown(const string& name) const { return WasKeyDown(GetAction(name)); }
 
 	protected:
 		virtual void Init() = 0;
 		virtual void DeInit() = 0;
 		virtual void Update(float deltaTime) = 0;
 		virtual void Render() = 0;
-		GLuint BuildShader(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr);
-		void UseShader(GLuint program);
+		// Setup for RunHeadless, in place of Init(). Nothing but the simulation may be touched.
+		// Runs on a worker in batches, so failures are returned rather than passed to Err().
+		// The default returns false, for games that cannot run headless.
+		virtual bool InitHeadless() { return false; }
+		// After a hot reload replaced programs, their uniforms are back to the defaults
+		virtual void OnShadersReloaded() {}
+		// Pipelined mode only. Runs on the update worker right after Update() and
+		// copies everything drawing needs into snapshot buffer (0 or 1). Games that
+		// do not override it are updated and rendered in turn with Render().
+		virtual void PrepareRender(unsigned int buffer);
+		// Pipelined mode only, draws the snapshot in buffer on the GL thread while
+		// the next Update() runs. Must not read anything Update() writes.
+		virtual void RenderPrepared(unsigned int buffer);
+		// The returned shader is owned by the game
+		Shader* BuildShader(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr);
+		void UseShader(Shader* shader);
+		// Render() records draws here, they are sorted and run right after it returns
+		RenderQueue& GetRenderQueue() { return renderQueue; }
+		// For GL state set outside the queue, like the clear colour
+		StateCache& GetStateCache() { return stateCache; }
+		// Stored in the shared "Frame" uniform block, uploaded once per frame
+		void SetProjection(const mat4& projection);
+		// Development mode: relinks shaders when their files change, a failed
+		// reload keeps the last good program instead of exiting
+		void EnableShaderHotReload();
+		// Runs Update() on a worker, one frame ahead of rendering, so simulation and
+		// GL submission overlap. Update() and Render() are replaced by PrepareRender()
+		// and RenderPrepared() on double buffered snapshots. Set before Start.
+		// Input, assets and SetProjection stay on the GL thread between updates.
+		void SetPipelined(bool enabled);
+		// Runs Update() with a fixed delta (ms, 0 disables), as often as the frame time requires
+		void SetFixedTimestep(float stepMs);
+		// Loads assets in the background, uploads are advanced every frame
+		AssetManager& GetAssets() { return assets; }
+		// Game logic must draw from this for recordings to replay the same way
+		Random& GetRandom() { return random; }
+		// How far the current frame is between the last two fixed updates, for interpolating in Render().
+		// Pipelined, it is the alpha captured with the snapshot RenderPrepared() draws.
+		float GetInterpolationAlpha() const { return interpolationAlpha; }
 		unsigned int GetScreenHeight();
 		unsigned int GetScreenWidth();
 		void Err(string errorString);
+		// Leaves the main loop after the current frame, DeInit() still runs
+		void Quit();
 
 	private:
-		unordered_map<unsigned int, string> _mapNames;
-		unordered_map<string, bool> _keyMap;
-		unordered_map<string, bool> _previousKeyMap;
+		struct ShaderSource {
+			string vertexPath, fragmentPath, geometryPath;
+		};
+		unordered_map<unsigned int, ActionID> _keyActions;
+		unordered_map<string, ActionID> _actionNames;
+		bitset<MAX_ACTIONS> _keyState;
+		bitset<MAX_ACTIONS> _previousKeyState;
 		vec2 _mouseCoords;
 		SDL_GameController *controller;
-		unsigned int screenWidth, screenHeight, lastFrame = 0, last = 0, _fps = 0, fps = 0;
-		float targetFrameTime = 0, timeScale;
+		unsigned int screenWidth, screenHeight, _fps = 0, fps = 0;
+		float timeScale, fixedTimestep = 0, accumulator = 0, interpolationAlpha = 0;
+		bool headless = false, pipelined = false;
+		// Cleared by the base PrepareRender(), the game then cannot be pipelined
+		bool pipelineHooks = true;
+		// Snapshot buffer RenderPrepared() draws next
+		unsigned int renderBuffer = 0;
+		// Interpolation alpha each snapshot buffer was prepared with
+		float snapshotAlpha[2] = { 0, 0 };
+		unsigned int frameCount = 0;
+		double lastFPSUpdate = 0;
+		FramePacer framePacer;
+		AssetManager assets;
 		State state;
+		vector<unique_ptr<Shader>> shaders;
+		vector<ShaderSource> shaderSources;
+		ProgramCache programCache;
+		ShaderWatcher shaderWatcher;
+		GLuint frameUBO = 0;
+		StateCache stateCache;
+		RenderQueue renderQueue;
+		FrameUniforms frameUniforms;
+		Random random;
+		InputRecorder recorder;
+		InputReplay replay;
+		vector<InputEvent> replayEvents;
 		float GetDeltaTime();
 		void GetFPS();
 		void PollInput();
+		void ApplyReplayEvents();
+		// Runs Update() once, or as many fixed steps as deltaTime adds up to, and
+		// returns the interpolation alpha left over
+		float Simulate(float deltaTime);
+		// Prepares the first snapshot after Init(), or falls back to Render()
+		void BeginPipeline();
+		// Runs this frame's update, on a worker when pipelined
+		future<void> BeginUpdate(float deltaTime);
+		void RenderFrame();
+		// Waits for a pipelined update and swaps the snapshot buffers
+		void EndUpdate(future<void>& update);
 		void LimitFPS();
-		void CheckShaderErrors(GLuint shader, string type);
+		bool CheckShaderErrors(GLuint shader, string type, string& error);
+		bool ReadShaderSources(const ShaderSource& source, string& vertexCode, string& fragmentCode, string& geometryCode);
+		GLuint LinkProgram(const string& vertexCode, const string& fragmentCode, const string& geometryCode, string& error);
+		void ReloadShaders();
+		void InitFrameUniforms();
+		void UploadFrameUniforms();
 		void PrintFPS();
 		void OpenGameController();
 		void CloseGameController();
@@ -0,0 +1,36 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <cstdint>
+
+#include "Board.h"
+#include "Random.h"
+
+// Restarts with a fresh plan before giving up, only tiny boards with few colours ever need one
+#define GENERATOR_MAX_ATTEMPTS 16
+
+namespace Engine {
+	// Fills a board in one pass with no run of 3 and at least one legal swap.
+	// A swap is planted first (two pieces, a gap and a third piece of the same
+	// colour in a line), then every other cell picks uniformly among the colours
+	// that do not complete a run with the pieces already placed around it.
+	class BoardGenerator
+	{
+	public:
+		// For starting and reshuffling, false if the board is too small or has too
+		// few colours to hold a legal swap without a match
+		static bool Generate(Board& board, Random& random);
+		// Same seed, same board
+		static bool Generate(Board& board, uint64_t seed)
+		{
+			Random random(seed);
+			return Generate(board, random);
+		}
+
+	private:
+		// Colours that would complete a run at (x, y), one bit each
+		static uint32_t Forbidden(const Board& board, int x, int y);
+		static bool Fill(Board& board, Random& random);
+	};
+}
+#endif
@@ -7,28 +7,43 @@
 #include <SDL/SDL_mixer.h>
 #include <SDL/SDL_thread.h>
 
-#include <ft2build.h>
-#include <freetype/freetype.h>
-#include <map>
-
 #include <GLM/glm.hpp>
 #include <GLM/gtc/matrix_transform.hpp>
 #include <GLM/gtc/type_ptr.hpp>
 
 #include "Game.h"
+#include "Font.h"
+#include "TextBatch.h"
+#include "TextMesh.h"
+#include "SpriteBatch.h"
+#include "AssetManager.h"
+#include "Atlas.h"
+#include "Audio.h"
+#include "ActionRepeat.h"
+#include "Tween.h"
 
 using namespace glm;
 
+// Text drawn at scale 1 is this many pixels high, the atlas itself is FONT_SDF_SIZE
 #define FONTSIZE 40
 #define FONTNAME "kenvector_future.ttf"
+// Optional, the menu stays silent without it
+#define MUSICNAME "music.ogg"
 #define NUM_BUTTON 5
+#define BUTTON_ATLAS_SIZE 512
+#define NUM_SOUND 5
+// Voice stealing order, a sound never interrupts a more important one
+#define SFX_PRIORITY_MOVE 0
+#define SFX_PRIORITY_CLICK 1
+#define SFX_PRIORITY_MATCH 2
+// Time given to the click sound before the menu closes
+#define EXIT_DELAY 200.0f
+// Cross fade between a button and its hover state, ms
+#define BUTTON_FADE_TIME 120.0f
 
-struct Character {
-	GLuint TextureID; // ID handle of the glyph texture
-	ivec2 Size; // Size of glyph
-	ivec2 Bearing; // Offset from baseline to left/top of glyph
-	GLuint Advance; // Offset to advance to next glyph
-};
+enum class MenuState { BROWSING, EXITING };
+enum class MenuEvent { NEXT, PREV, SELECT };
+enum class MusicState { STOPPED, PLAYING, PAUSED };
 
 class Menu :
 	public Engine::Game
@@ -41,24 +56,55 @@ public:
 	virtual void Update(float deltaTime);
 	virtual void Render();
 	void InitAudio();
+protected:
+	virtual void OnShadersReloaded();
 private:
+	// Uniforms that never change between draws, set once per program
+	void SetupShaders();
 	void InitText();
-	void RenderText(string text, GLfloat x, GLfloat y, GLfloat scale, vec3 color);
+	void RenderText(const string& text, GLfloat x, GLfloat y, GLfloat scale, vec3 color);
 	void InitButton();
 	void RenderButton();
-	map<GLchar, Character> Characters;
-	GLuint texture[NUM_BUTTON], hover_texture[NUM_BUTTON], VBO, VBO2, VAO, VAO2, program;
+	// Picks up assets finished by the workers
+	void PollAssets();
+	void HandleEvent(MenuEvent event);
+	void SetActiveButton(int index);
+	void SetMusicState(MusicState next);
+	Engine::Font font;
+	Engine::TextBatch textBatch;
+	Engine::TextMesh title;
+	Engine::SpriteBatch spriteBatch;
+	GLuint buttonAtlas;
+	Engine::Shader* shader;
+	Engine::Shader* spriteShader;
+	int textUniform, textureUniform, modelUniform, spriteTextureUniform, glowColorUniform, glowWidthUniform;
 	float button_width[NUM_BUTTON], button_height[NUM_BUTTON], hover_button_width[NUM_BUTTON], hover_button_height[NUM_BUTTON];
+	vec4 button_uv[NUM_BUTTON], hover_button_uv[NUM_BUTTON];
+	// Normal buttons first, then the hover states
+	shared_future<shared_ptr<Engine::Image>> buttonImages[NUM_BUTTON * 2];
+	shared_future<void> buttonUploads[NUM_BUTTON * 2];
+	Engine::AtlasPacker buttonPacker = Engine::AtlasPacker(BUTTON_ATLAS_SIZE, BUTTON_ATLAS_SIZE);
+	shared_future<shared_ptr<Engine::FontBitmap>> fontBitmap;
+	bool fontReady = false;
+	shared_future<Engine::AudioAsset<Mix_Chunk>> soundLoads[NUM_SOUND];
 	int activeButtonIndex = 0;
-	Mix_Music* menuClickSound = NULL;
-	Mix_Music* gameClickSound = NULL;
-	Mix_Music* switchSound = NULL;
-	Mix_Music* matchSound = NULL;
-	Mix_Music* moveSound = NULL;
-	//Mix_Chunk* sound = NULL;
-	//Mix_Chunk* sound = NULL;
-	Mix_Music* music = NULL;
-	int sfx_channel = -1;
+	// How far each button has faded to its hover state, animated by tweens
+	float buttonHover[NUM_BUTTON] = { 1.0f };
+	Engine::TweenSystem tweens;
+	ActionID selectAction, nextAction, prevAction, profileAction, musicAction;
+	// Select never repeats, navigation repeats while held
+	Engine::ActionRepeat selectRepeat = Engine::ActionRepeat(0, 0);
+	Engine::ActionRepeat nextRepeat, prevRepeat;
+	MenuState menuState = MenuState::BROWSING;
+	MusicState musicState = MusicState::STOPPED;
+	float exitTimer = 0;
+	Engine::Audio audio;
+	SoundID menuClickSound = INVALID_SOUND;
+	SoundID gameClickSound = INVALID_SOUND;
+	SoundID switchSound = INVALID_SOUND;
+	SoundID matchSound = INVALID_SOUND;
+	SoundID moveSound = INVALID_SOUND;
+	shared_future<Engine::AudioAsset<Mix_Music>> musicLoad;
 };
 #endif
 
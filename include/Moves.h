@@ -0,0 +1,49 @@
+#ifndef MOVES_H
+#define MOVES_H
+
+#include <vector>
+#include <cstdint>
+
+#include "Board.h"
+#include "Random.h"
+
+using namespace std;
+
+namespace Engine {
+	// Swap of (x, y) with its right neighbour, or with the cell below when vertical
+	struct Move {
+		uint8_t x;
+		uint8_t y;
+		bool vertical;
+	};
+
+	// Bit x of horizontal[y] is the swap (x, y) <-> (x + 1, y),
+	// bit x of vertical[y] is the swap (x, y) <-> (x, y + 1)
+	struct MoveMask {
+		uint64_t horizontal[BOARD_MAX_HEIGHT];
+		uint64_t vertical[BOARD_MAX_HEIGHT];
+	};
+
+	// Finds every swap that creates a match on a settled board without trying
+	// them. For each colour the cells that would complete a run are computed
+	// with shifts and ANDs of the row bitboards, then intersected with the
+	// pieces of that colour next to them.
+	class MoveGenerator
+	{
+	public:
+		// Returns true if there is any legal swap
+		static bool Generate(const Board& board, MoveMask& moves);
+		static void List(const Board& board, vector<Move>& moves);
+		// Counting only, for deadlock checks and scoring boards
+		static unsigned int Count(const Board& board);
+		// Stops at the first legal swap found
+		static bool HasMove(const Board& board);
+		// A random legal swap for the idle hint, false when the board is deadlocked
+		static bool Hint(const Board& board, Random& random, Move& move);
+
+	private:
+		// Legal horizontal swaps in row y and vertical swaps between rows y and y + 1
+		static void ScanRow(const Board& board, int y, uint64_t& horizontal, uint64_t& vertical);
+	};
+}
+#endif
@@ -0,0 +1,49 @@
+#ifndef OFFSCREEN_H
+#define OFFSCREEN_H
+
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+#ifdef OFFSCREEN_OSMESA
+#include <GL/osmesa.h>
+#else
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+using namespace std;
+
+#define OFFSCREEN_GL_MAJOR 3
+#define OFFSCREEN_GL_MINOR 3
+
+namespace Engine {
+	// GL context without a window or a display, for benchmarks on build machines.
+	// Uses EGL surfaceless (Mesa llvmpipe when there is no GPU), or OSMesa when
+	// built with OFFSCREEN_OSMESA. Rendering goes into a framebuffer object of the
+	// requested size, which is left bound.
+	class OffscreenContext
+	{
+	public:
+		~OffscreenContext();
+		// Also initialises GLEW
+		bool Create(unsigned int width, unsigned int height, string& error);
+		void Destroy();
+		GLuint GetFramebuffer() const { return framebuffer; }
+		// Reads the colour buffer back, top row first, and writes it as a binary PPM
+		bool SaveImage(const string& path) const;
+
+	private:
+		bool CreateContext(string& error);
+		unsigned int width = 0, height = 0;
+		GLuint framebuffer = 0, colour = 0, depth = 0;
+#ifdef OFFSCREEN_OSMESA
+		OSMesaContext context = nullptr;
+		// OSMesa always needs a buffer to draw to, the FBO is what actually gets used
+		vector<unsigned char> buffer;
+#else
+		EGLDisplay display = EGL_NO_DISPLAY;
+		EGLContext context = EGL_NO_CONTEXT;
+#endif
+	};
+}
+#endif
@@ -0,0 +1,78 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <GL/glew.h>
+#include <vector>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+#include "RenderQueue.h"
+#include "ThreadPool.h"
+#include "Random.h"
+
+using namespace std;
+using namespace glm;
+
+#define PARTICLES_DEFAULT_CAPACITY 131072
+// Fewer live particles than this are updated on the calling thread
+#define PARTICLES_PARALLEL_MIN 16384
+
+namespace Engine {
+	// How the particles of one Emit call start out. Speeds are in pixels per
+	// second, lifetimes in ms, sizes in pixels from birth to death.
+	struct ParticleBurst {
+		float speedMin, speedMax;
+		float lifeMin, lifeMax;
+		float sizeStart, sizeEnd;
+		// Radians, the burst is spread evenly around direction
+		float direction, spread;
+		vec4 color;
+	};
+
+	// Fixed capacity pool of particles stored as one array per attribute, so the
+	// update is a few straight loops over floats the compiler can vectorise and
+	// the arrays are uploaded as they are, one instance stream each. Dead
+	// particles are compacted away in place, nothing is allocated after Init.
+	// Every live particle is drawn by one instanced draw with a single material.
+	class ParticleSystem
+	{
+	public:
+		ParticleSystem(size_t capacity = PARTICLES_DEFAULT_CAPACITY, uint64_t seed = 1);
+		~ParticleSystem();
+		// Creates the GL buffers, not needed for simulation only
+		void Init();
+		// Pixels per second squared, applied to every particle
+		void SetGravity(vec2 gravity) { this->gravity = gravity; }
+		// Fraction of the velocity kept after one second
+		void SetDrag(float drag) { this->drag = drag; }
+		// Spawns up to count particles at position, returns how many fitted
+		size_t Emit(const ParticleBurst& burst, vec2 position, size_t count);
+		// Advances by deltaTime ms and removes the particles that died. Large pools
+		// are split across the pool's workers when one is given
+		void Update(float deltaTime, ThreadPool* pool = nullptr);
+		void Clear() { count = 0; }
+		// Takes the drawn attributes of source, for a snapshot that is only
+		// submitted while source keeps updating on another thread
+		void CopyDrawState(const ParticleSystem& source);
+		// Records the draw. The arrays are read when the queue runs, so Update must not run in between
+		void Submit(RenderQueue& queue, RenderPass pass, int layer, Shader* shader, BlendMode blend = BlendMode::ADDITIVE);
+		size_t GetCount() const { return count; }
+		size_t GetCapacity() const { return capacity; }
+
+	private:
+		void Integrate(size_t first, size_t last, float seconds, float dragFactor);
+		void Compact();
+		static void Draw(void* owner, uint32_t argument, StateCache& state);
+		size_t capacity, count = 0;
+		// Simulation state
+		vector<float> x, y, vx, vy, age, invLife, sizeStart, sizeDelta;
+		// Drawn per instance along with x and y: current size, age over lifetime and tint
+		vector<float> size, life;
+		vector<uint32_t> colors;
+		vec2 gravity = vec2(0);
+		float drag = 1;
+		Random random;
+		GLuint VAO = 0, quadVBO = 0, instanceVBO = 0;
+	};
+}
+#endif
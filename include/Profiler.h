@@ -0,0 +1,116 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <GL/glew.h>
+#include <SDL/SDL.h>
+#include <string>
+#include <atomic>
+#include <cstdint>
+
+using namespace std;
+
+#define PROFILER_MAX_SAMPLES 65536 // Must be a power of two
+#define PROFILER_MAX_FRAMES 1024
+#define PROFILER_MAX_GPU_SCOPES 32 // Per frame
+#define PROFILER_GPU_LATENCY 4 // Frames between issuing a timer query and reading it back
+#define PROFILER_GPU_THREAD 0xFFFF
+
+namespace Engine {
+	struct ProfileSample {
+		const char* name;
+		uint64_t begin, end; // Performance counter ticks
+		uint32_t thread;
+		uint32_t depth;
+	};
+
+	struct FrameCounters {
+		uint32_t drawCalls = 0;
+		uint32_t stateChanges = 0;
+		uint64_t uploadBytes = 0;
+	};
+
+	// Collects nested CPU scopes from any thread into a lock-free ring buffer,
+	// GPU scopes through timestamp queries and per frame render counters.
+	// Everything can be dumped as a Chrome trace (chrome://tracing).
+	class Profiler
+	{
+	public:
+		static Profiler& Get();
+		// Creates the timer queries, needs a current GL context
+		void InitGpu();
+		// Called by the main loop around every frame
+		void BeginFrame();
+		void EndFrame();
+		uint64_t Now() const { return SDL_GetPerformanceCounter(); }
+		void Record(const char* name, uint64_t begin, uint64_t end, uint32_t depth);
+		void BeginGpuScope(const char* name);
+		void EndGpuScope();
+		void CountDrawCall(uint32_t count = 1) { current.drawCalls += count; }
+		void CountStateChange(uint32_t count = 1) { current.stateChanges += count; }
+		void CountUpload(uint64_t bytes) { current.uploadBytes += bytes; }
+		const FrameCounters& GetLastFrameCounters() const { return last; }
+		bool ExportChromeTrace(const string& path);
+		// Prints p50/p99 frame times and average counters over the recorded frames
+		void PrintSummary();
+		static uint32_t GetThreadID();
+
+	private:
+		Profiler();
+		// Fields are relaxed atomics, a reader may copy a slot while a writer reuses it
+		struct Slot {
+			atomic<uint64_t> sequence;
+			atomic<const char*> name;
+			atomic<uint64_t> begin, end;
+			atomic<uint32_t> thread, depth;
+		};
+		struct GpuScope {
+			const char* name;
+			GLuint queries[2];
+			uint32_t depth;
+		};
+		void Push(const ProfileSample& sample);
+		void ReadGpuFrame(unsigned int frameSlot);
+		Slot* samples;
+		atomic<uint64_t> writeIndex;
+		double ticksToMs;
+		// Frame history, only touched by the main thread
+		float frameTimes[PROFILER_MAX_FRAMES];
+		FrameCounters frameCounters[PROFILER_MAX_FRAMES];
+		uint64_t frameCount = 0, frameBegin = 0;
+		FrameCounters current, last;
+		// Timer queries, kept for PROFILER_GPU_LATENCY frames so reading them never stalls
+		bool gpuEnabled = false;
+		GpuScope gpuScopes[PROFILER_GPU_LATENCY][PROFILER_MAX_GPU_SCOPES];
+		unsigned int gpuScopeCount[PROFILER_GPU_LATENCY] = {};
+		unsigned int gpuStack[PROFILER_MAX_GPU_SCOPES];
+		unsigned int gpuDepth = 0;
+		// GPU timestamp (ns) of CPU tick gpuSyncTicks
+		int64_t gpuSyncTime = 0;
+		uint64_t gpuSyncTicks = 0;
+	};
+
+	// Times the enclosing block
+	class ProfileScope
+	{
+	public:
+		ProfileScope(const char* name);
+		~ProfileScope();
+
+	private:
+		const char* name;
+		uint64_t begin;
+	};
+
+	class GpuProfileScope
+	{
+	public:
+		GpuProfileScope(const char* name) { Profiler::Get().BeginGpuScope(name); }
+		~GpuProfileScope() { Profiler::Get().EndGpuScope(); }
+	};
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) Engine::ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_GPU_SCOPE(name) Engine::GpuProfileScope PROFILE_CONCAT(gpuProfileScope, __LINE__)(name)
+#endif
@@ -0,0 +1,37 @@
+#ifndef PROGRAMCACHE_H
+#define PROGRAMCACHE_H
+
+#include <GL/glew.h>
+#include <string>
+#include <cstdint>
+
+using namespace std;
+
+#define PROGRAM_CACHE_DIR "shadercache"
+#define PROGRAM_CACHE_MAGIC 0x42504856 // "VHPB"
+#define PROGRAM_CACHE_VERSION 1
+
+namespace Engine {
+	// Stores linked program binaries on disk, keyed by a hash of the shader
+	// sources and the driver, so a warm start does not compile anything.
+	class ProgramCache
+	{
+	public:
+		ProgramCache();
+		~ProgramCache();
+		// Must be called with a current GL context, disables itself when the driver has no binary format
+		void Init();
+		bool IsEnabled() const { return enabled; }
+		uint64_t MakeKey(const string& vertexCode, const string& fragmentCode, const string& geometryCode) const;
+		// Loads the binary into the program, returns false if missing, stale or rejected by the driver
+		bool Load(uint64_t key, GLuint program);
+		void Save(uint64_t key, GLuint program);
+		static uint64_t Hash(const void* data, size_t length, uint64_t seed = 14695981039346656037ULL);
+
+	private:
+		string GetPath(uint64_t key) const;
+		bool enabled = false;
+		string driver;
+	};
+}
+#endif
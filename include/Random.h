@@ -0,0 +1,46 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+namespace Engine {
+	// xoshiro256** generator. Small, fast and copyable, so simulations can fork
+	// their own streams and replays get the same sequence from the same seed.
+	class Random
+	{
+	public:
+		Random(uint64_t seed = 0x9E3779B97F4A7C15ULL) { Seed(seed); }
+		void Seed(uint64_t seed)
+		{
+			// splitmix64 spreads the seed so nearby seeds give unrelated streams
+			for (int i = 0; i < 4; i++) {
+				seed += 0x9E3779B97F4A7C15ULL;
+				uint64_t z = seed;
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+				state[i] = z ^ (z >> 31);
+			}
+		}
+		uint64_t Next()
+		{
+			uint64_t result = Rotate(state[1] * 5, 7) * 9;
+			uint64_t t = state[1] << 17;
+			state[2] ^= state[0];
+			state[3] ^= state[1];
+			state[1] ^= state[2];
+			state[0] ^= state[3];
+			state[2] ^= t;
+			state[3] = Rotate(state[3], 45);
+			return result;
+		}
+		// Uniform in [0, range), multiply-shift instead of a modulo
+		uint32_t NextInt(uint32_t range) { return (uint32_t)(((Next() >> 32) * range) >> 32); }
+		// Uniform in [0, 1)
+		float NextFloat() { return (Next() >> 40) * (1.0f / 16777216.0f); }
+
+	private:
+		static uint64_t Rotate(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+		uint64_t state[4];
+	};
+}
+#endif
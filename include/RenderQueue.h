@@ -0,0 +1,93 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <GL/glew.h>
+#include <vector>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+#include "Shader.h"
+
+using namespace std;
+using namespace glm;
+
+#define RENDERQUEUE_INITIAL_CAPACITY 256
+#define RENDER_MAX_TEXTURE_UNITS 8
+// Low key bits index the command, which also keeps submission order for equal materials
+#define RENDERQUEUE_SEQUENCE_BITS 22
+
+namespace Engine {
+	// REPLACE writes the colour as is
+	enum class BlendMode : uint8_t { REPLACE, ALPHA, ADDITIVE };
+
+	// Most significant part of the sort key, passes are drawn in this order
+	enum RenderPass : uint8_t { RENDER_PASS_BACKGROUND, RENDER_PASS_WORLD, RENDER_PASS_EFFECTS, RENDER_PASS_UI };
+
+	// Remembers the GL state it set and drops calls that would not change it.
+	// Every call that does reach GL is counted as a state change by the profiler.
+	class StateCache
+	{
+	public:
+		StateCache() { Invalidate(); }
+		// Forget everything, after GL calls made behind the cache's back
+		void Invalidate();
+		// Only the object bindings, programs and blending are never touched elsewhere
+		void InvalidateBindings();
+		void UseProgram(GLuint program);
+		void BindVertexArray(GLuint vertexArray);
+		void BindArrayBuffer(GLuint buffer);
+		void BindTexture(unsigned int unit, GLuint texture);
+		void SetBlend(BlendMode mode);
+		void SetClearColor(const vec4& color);
+
+	private:
+		GLuint program, vertexArray, arrayBuffer;
+		GLuint textures[RENDER_MAX_TEXTURE_UNITS];
+		unsigned int activeUnit;
+		BlendMode blend;
+		bool blendKnown, clearColorKnown;
+		vec4 clearColor;
+	};
+
+	// What a draw needs bound, commands sharing one are drawn without state changes in between
+	struct Material {
+		Shader* shader;
+		GLuint texture;
+		BlendMode blend;
+	};
+
+	// Draws once the material is bound. Plain function and owner pointer, so
+	// recording a command never allocates.
+	typedef void (*RenderCallback)(void* owner, uint32_t argument, StateCache& state);
+
+	struct RenderCommand {
+		Material material;
+		RenderCallback callback;
+		void* owner;
+		uint32_t argument;
+	};
+
+	// Render() only records draw commands. Execute sorts them by a 64 bit key of
+	// pass, layer, shader, texture and blend mode, then binds each material once
+	// through the state cache, so state changes follow the number of distinct
+	// materials rather than the number of places that draw.
+	// Key layout from the top: pass 4, layer 8, shader 10, texture 16, blend 4, sequence 22.
+	class RenderQueue
+	{
+	public:
+		RenderQueue();
+		// Layers order draws inside a pass, -128 to 127
+		void Submit(RenderPass pass, int layer, const Material& material, RenderCallback callback, void* owner, uint32_t argument = 0);
+		// Runs and clears the queue
+		void Execute(StateCache& state);
+		size_t GetCommandCount() const { return commands.size(); }
+		// Material switches done by the last Execute
+		unsigned int GetMaterialChanges() const { return materialChanges; }
+
+	private:
+		vector<RenderCommand> commands;
+		vector<uint64_t> keys;
+		unsigned int materialChanges = 0;
+	};
+}
+#endif
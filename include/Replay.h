@@ -0,0 +1,71 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+using namespace std;
+
+#define REPLAY_MAGIC "VHIR"
+#define REPLAY_VERSION 1
+// Bytes gathered before the recorder writes to disk
+#define REPLAY_FLUSH_SIZE (64 * 1024)
+
+namespace Engine {
+	enum InputEventType : uint8_t { INPUT_PRESS, INPUT_RELEASE, INPUT_MOUSE };
+
+	struct InputEvent {
+		InputEventType type;
+		unsigned int key;
+		// Whole pixels, as SDL reports them
+		int x, y;
+	};
+
+	// Writes the frame deltas and the mapped input of a session to a binary log.
+	// After the header (magic, version, seed) every frame is the raw 32 bit delta,
+	// a varint event count and the events: a type byte followed by a varint key
+	// or two zigzag varint coordinates. A frame without input takes 5 bytes.
+	class InputRecorder
+	{
+	public:
+		~InputRecorder();
+		bool Open(const string& path, uint64_t seed);
+		void Close();
+		bool IsRecording() const { return file.is_open(); }
+		// Events recorded after this belong to the new frame
+		void BeginFrame(float deltaTime);
+		void Record(const InputEvent& event);
+
+	private:
+		void WriteFrame();
+		void WriteVarint(uint64_t value);
+		ofstream file;
+		vector<uint8_t> buffer;
+		vector<InputEvent> events;
+		float deltaTime = 0;
+		bool inFrame = false;
+	};
+
+	// Reads a log written by InputRecorder back one frame at a time
+	class InputReplay
+	{
+	public:
+		// Loads the whole log, false if it is missing or not a replay
+		bool Open(const string& path);
+		void Close();
+		bool IsPlaying() const { return playing; }
+		uint64_t GetSeed() const { return seed; }
+		// False once the log is used up or damaged
+		bool NextFrame(float& deltaTime, vector<InputEvent>& events);
+
+	private:
+		bool ReadVarint(uint64_t& value);
+		vector<uint8_t> data;
+		size_t position = 0;
+		uint64_t seed = 0;
+		bool playing = false;
+	};
+}
+#endif
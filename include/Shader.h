@@ -0,0 +1,59 @@
+#ifndef SHADER_H
+#define SHADER_H
+
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <GLM/glm.hpp>
+
+using namespace std;
+using namespace glm;
+
+// Binding point of the uniform block every shader shares for per frame data
+#define FRAME_UNIFORM_BINDING 0
+#define FRAME_UNIFORM_BLOCK "Frame"
+
+namespace Engine {
+	// Layout of the "Frame" uniform block (std140)
+	struct FrameUniforms {
+		mat4 projection;
+	};
+
+	// A linked program with every active uniform reflected at link time.
+	// Setters take the handle returned by GetUniform and skip the upload when
+	// the value did not change. They act on the bound program like glUniform does.
+	class Shader
+	{
+	public:
+		Shader();
+		~Shader();
+		// Takes ownership of a linked program and reflects its uniforms.
+		// Attaching a new program keeps the existing uniform handles
+		void Attach(GLuint program);
+		GLuint GetProgram() const { return program; }
+		// Returns -1 when the program has no active uniform with that name
+		int GetUniform(const string& name) const;
+		void SetInt(int uniform, GLint value);
+		void SetFloat(int uniform, GLfloat value);
+		void SetVec2(int uniform, const vec2& value);
+		void SetVec3(int uniform, const vec3& value);
+		void SetVec4(int uniform, const vec4& value);
+		void SetMat4(int uniform, const mat4& value);
+
+	private:
+		struct Uniform {
+			GLint location;
+			GLenum type;
+			bool cached;
+			// Last uploaded value, large enough for a mat4
+			GLfloat value[16];
+		};
+		// Returns false when the value is already on the GPU
+		bool Store(int uniform, const void* value, size_t size);
+		GLuint program = 0;
+		vector<Uniform> uniforms;
+		unordered_map<string, int> uniformNames;
+	};
+}
+#endif
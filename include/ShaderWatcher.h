@@ -0,0 +1,38 @@
+#ifndef SHADERWATCHER_H
+#define SHADERWATCHER_H
+
+#include <string>
+#include <vector>
+#include <set>
+#include <mutex>
+#include <thread>
+#include <atomic>
+
+using namespace std;
+
+#define SHADER_WATCH_INTERVAL 100 // ms
+
+namespace Engine {
+	// Watches shader files on a background thread (inotify on Linux, modification
+	// times elsewhere) and reports the ones that changed since the last call.
+	class ShaderWatcher
+	{
+	public:
+		ShaderWatcher();
+		~ShaderWatcher();
+		void Start(const vector<string>& paths);
+		void Stop();
+		bool IsRunning() const { return running; }
+		// Returns the paths written since the last call, empty if nothing changed
+		vector<string> TakeChanged();
+
+	private:
+		void Run();
+		vector<string> paths;
+		set<string> changed;
+		mutex changedMutex;
+		thread worker;
+		atomic<bool> running;
+	};
+}
+#endif
@@ -0,0 +1,120 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <cstdint>
+#include <cstring>
+
+#include "Board.h"
+#include "Moves.h"
+#include "Cascade.h"
+#include "Random.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+#define SOLVER_DEFAULT_DEPTH 3
+// Refills sampled per swap, the chance nodes of the expectimax
+#define SOLVER_DEFAULT_SAMPLES 4
+#define SOLVER_DEFAULT_BUDGET 8.0
+// 2^20 entries of 16 bytes
+#define SOLVER_TABLE_BITS 20
+// Future clears count for a bit less than clears now
+#define SOLVER_DISCOUNT 0.9f
+
+namespace Engine {
+	// Random key per cell and colour, a board hashes to the XOR of its pieces
+	class Zobrist
+	{
+	public:
+		static uint64_t Hash(const Board& board);
+
+	private:
+		static const uint64_t* GetKeys();
+	};
+
+	// Fixed size table shared by all search threads without locks. Each slot
+	// stores key ^ data next to data, a slot torn by two writers no longer
+	// matches its key and reads as a miss.
+	class TranspositionTable
+	{
+	public:
+		TranspositionTable(unsigned int bits = SOLVER_TABLE_BITS);
+		// True if the board was stored after a search exactly depth moves deep
+		bool Probe(uint64_t key, int depth, float& value) const;
+		void Store(uint64_t key, int depth, float value);
+		void Clear();
+
+	private:
+		struct Slot {
+			atomic<uint64_t> check;
+			atomic<uint64_t> data;
+		};
+		vector<Slot> slots;
+		uint64_t mask;
+	};
+
+	struct SolverResult {
+		Move move;
+		// Expected pieces cleared by the best move and the moves after it
+		float score;
+		// Mean over every legal move, low on boards where most moves are poor
+		float average;
+		unsigned int moveCount;
+		// Deepest search that finished within the budget
+		int depth;
+		unsigned int nodes;
+		bool found;
+	};
+
+	// Picks the swap with the best expected clears a few moves ahead. Refills
+	// are random, so each swap is averaged over sampled refills (expectimax).
+	// Root swaps and samples run as tasks on the thread pool, deeper levels run
+	// inside those tasks and share results through the transposition table.
+	// Deepens one move at a time until the budget runs out.
+	class Solver
+	{
+	public:
+		Solver(ThreadPool& pool = ThreadPool::GetDefault());
+		void SetDepth(int depth) { maxDepth = depth; }
+		// Also clears the table
+		void SetSamples(int samples);
+		// Milliseconds per decision, 0 searches to full depth however long it takes
+		void SetBudget(double budgetMs) { this->budgetMs = budgetMs; }
+		// Blocks until the search is done, the calling thread helps with the tasks
+		SolverResult Solve(const Board& board);
+		// Searches in the background, poll IsReady from Game::Update and then
+		// take the result with GetResult. The board is copied, one search at a time.
+		void Begin(const Board& board);
+		bool IsSearching() const { return search.valid(); }
+		bool IsReady() const { return Engine::IsReady(search); }
+		SolverResult GetResult() { return search.get(); }
+		TranspositionTable& GetTable() { return table; }
+
+	private:
+		struct RootMove {
+			Move move;
+			vector<future<float>> samples;
+		};
+		// Best expected value over the legal swaps of a settled board
+		float Search(const Board& board, uint64_t hash, int depth);
+		// Swaps, resolves with a refill stream picked by sample, then searches on
+		float Sample(const Board& board, uint64_t hash, const Move& move, int sample, int depth);
+		bool Expired() const;
+		ThreadPool& pool;
+		TranspositionTable table;
+		future<SolverResult> search;
+		chrono::steady_clock::time_point deadline;
+		atomic<bool> aborted;
+		atomic<unsigned int> nodes;
+		// Depth of the root iteration in progress
+		atomic<int> iteration;
+		int maxDepth = SOLVER_DEFAULT_DEPTH;
+		int samples = SOLVER_DEFAULT_SAMPLES;
+		double budgetMs = SOLVER_DEFAULT_BUDGET;
+	};
+}
+#endif
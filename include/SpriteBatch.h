@@ -0,0 +1,68 @@
+#ifndef SPRITEBATCH_H
+#define SPRITEBATCH_H
+
+#include <GL/glew.h>
+#include <vector>
+#include <GLM/glm.hpp>
+
+#include "RenderQueue.h"
+
+using namespace std;
+using namespace glm;
+
+#define SPRITEBATCH_INITIAL_CAPACITY 1024
+
+namespace Engine {
+	struct Sprite {
+		GLuint texture;
+		int layer;
+		vec2 position; // Top left corner in screen space
+		vec2 size;
+		vec4 uv; // Top left and bottom right texture coords
+		vec4 tint;
+	};
+
+	// Per instance attributes streamed to the sprite shader
+	struct SpriteInstance {
+		GLfloat x, y, w, h;
+		GLfloat u0, v0, u1, v1;
+		GLubyte r, g, b, a;
+	};
+
+	// Collects sprites during Render(), sorts them by layer and texture and submits
+	// every run sharing a texture as one instanced draw to the render queue.
+	class SpriteBatch
+	{
+	public:
+		SpriteBatch();
+		~SpriteBatch();
+		void Init();
+		void Begin();
+		void Draw(GLuint texture, vec2 position, vec2 size, vec4 uv = vec4(0, 0, 1, 1), vec4 tint = vec4(1), int layer = 0);
+		// Sorts the sprites and records their draws, they stay queued until the render queue has run
+		void Submit(RenderQueue& queue, RenderPass pass, Shader* shader);
+		unsigned int GetDrawCallCount() const { return drawCalls; }
+		unsigned int GetSpriteCount() const { return spriteCount; }
+
+	private:
+		struct Run {
+			size_t first, count;
+		};
+		void Reserve(size_t count);
+		// Writes every instance of the frame, done by the first run drawn.
+		// Returns false if the buffer could not be mapped.
+		bool Upload(StateCache& state);
+		static void DrawRun(void* owner, uint32_t run, StateCache& state);
+		vector<Sprite> sprites;
+		vector<SpriteInstance> instances;
+		vector<Run> runs;
+		bool uploaded = false, uploadFailed = false;
+		GLuint VAO = 0, quadVBO = 0, instanceVBO = 0;
+		// Instance buffer is kept across frames and written in ring fashion
+		size_t capacity = 0, writeOffset = 0;
+		// Where this frame's instances were written
+		size_t drawOffset = 0;
+		unsigned int drawCalls = 0, spriteCount = 0;
+	};
+}
+#endif
@@ -0,0 +1,47 @@
+#ifndef TEXTBATCH_H
+#define TEXTBATCH_H
+
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+#include <GLM/glm.hpp>
+
+#include "Font.h"
+#include "RenderQueue.h"
+
+using namespace std;
+using namespace glm;
+
+// Per draw call, longer batches are split
+#define TEXTBATCH_MAX_GLYPHS 4096
+
+namespace Engine {
+	struct TextVertex {
+		GLfloat x, y; // Position
+		GLfloat u, v; // Texture coords inside the font atlas
+		GLubyte r, g, b, a; // Color
+	};
+
+	// Collects the glyph quads of every string drawn with one font during a frame
+	// and submits them as a single indexed draw to the render queue.
+	class TextBatch
+	{
+	public:
+		TextBatch();
+		~TextBatch();
+		void Init();
+		void Begin(const Font* font);
+		void AddText(const string& text, GLfloat x, GLfloat y, GLfloat scale, vec4 color);
+		// Records the draw, the quads stay queued until the render queue has run
+		void Submit(RenderQueue& queue, RenderPass pass, int layer, Shader* shader);
+		unsigned int GetQuadCount() const { return (unsigned int)vertices.size() / 4; }
+
+	private:
+		// Uploads and draws one TEXTBATCH_MAX_GLYPHS chunk
+		static void DrawChunk(void* owner, uint32_t chunk, StateCache& state);
+		const Font* font = nullptr;
+		vector<TextVertex> vertices;
+		GLuint VAO = 0, VBO = 0, EBO = 0;
+	};
+}
+#endif
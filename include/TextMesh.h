@@ -0,0 +1,74 @@
+#ifndef TEXTMESH_H
+#define TEXTMESH_H
+
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+#include <GLM/glm.hpp>
+
+#include "Font.h"
+#include "TextBatch.h"
+#include "RenderQueue.h"
+
+using namespace std;
+using namespace glm;
+
+// 16 bit indices, four vertices per glyph
+#define TEXTMESH_MAX_GLYPHS 16384
+
+namespace Engine {
+	// Horizontal placement relative to the position
+	enum class TextAlign : uint8_t { LEFT, CENTER, RIGHT };
+
+	// A string laid out once into its own GPU buffer, for text that rarely changes
+	// such as titles, labels and scores. Setters compare with the current value:
+	// a new string, font or scale redoes the layout, a new colour, position or
+	// alignment only rewrites the vertices, and anything else costs nothing. The
+	// upload happens when the render queue draws the mesh.
+	class TextMesh
+	{
+	public:
+		TextMesh();
+		~TextMesh();
+		// Creates the buffers, must be called on the thread owning the GL context
+		void Init();
+		void SetFont(const Font* font);
+		void SetText(const string& text);
+		// 1 draws glyphs at the size the font was rasterised at
+		void SetScale(float scale);
+		void SetColor(vec4 color);
+		// Top of the capital letters, horizontally anchored by the alignment
+		void SetPosition(vec2 position);
+		void SetAlign(TextAlign align);
+		const string& GetText() const { return text; }
+		// Width and cap height of the laid out string
+		vec2 GetSize();
+		// Width of text without building a mesh
+		static float Measure(const Font& font, const string& text, float scale);
+		// Records the draw, the mesh must stay alive until the render queue has run
+		void Submit(RenderQueue& queue, RenderPass pass, int layer, Shader* shader);
+
+	private:
+		struct Quad {
+			vec4 rect; // Top left and bottom right, relative to the pen start
+			vec4 uv;
+		};
+		void Layout();
+		void Build();
+		static void Draw(void* owner, uint32_t argument, StateCache& state);
+		const Font* font = nullptr;
+		string text;
+		float scale = 1;
+		vec4 color = vec4(1);
+		vec2 position = vec2(0);
+		TextAlign align = TextAlign::LEFT;
+		vec2 size = vec2(0);
+		vector<Quad> quads;
+		vector<TextVertex> vertices;
+		bool layoutDirty = true, verticesDirty = true, uploadDirty = true;
+		GLuint VAO = 0, VBO = 0, EBO = 0;
+		// Glyphs the buffers currently have room for
+		size_t capacity = 0;
+	};
+}
+#endif
@@ -0,0 +1,76 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+
+using namespace std;
+
+namespace Engine {
+	template<class T>
+	bool IsReady(const future<T>& f) { return f.valid() && f.wait_for(chrono::seconds(0)) == future_status::ready; }
+	template<class T>
+	bool IsReady(const shared_future<T>& f) { return f.valid() && f.wait_for(chrono::seconds(0)) == future_status::ready; }
+
+	// Fixed set of worker threads with one task deque each. Workers push and pop
+	// their own tasks at the back and steal from the front of the others when
+	// they run dry, tasks from other threads go to a shared queue.
+	class ThreadPool
+	{
+	public:
+		// 0 workers means one per core minus the main thread
+		ThreadPool(unsigned int workers = 0);
+		~ThreadPool();
+		// Shared pool used by the engine subsystems, created on first use
+		static ThreadPool& GetDefault();
+		void Submit(function<void()> task);
+		// Runs f on a worker and returns a future for its result
+		template<class F>
+		auto Async(F f) -> future<decltype(f())>
+		{
+			auto task = make_shared<packaged_task<decltype(f())()>>(f);
+			future<decltype(f())> result = task->get_future();
+			Submit([task]() { (*task)(); });
+			return result;
+		}
+		// Runs one queued task on the calling thread, false if there was none
+		bool RunPendingTask();
+		// Blocks until f is ready, running queued tasks meanwhile so tasks can
+		// wait on tasks they submitted without starving the pool
+		template<class T>
+		void Wait(const future<T>& f)
+		{
+			while (!IsReady(f)) {
+				if (!RunPendingTask()) {
+					this_thread::yield();
+				}
+			}
+		}
+		unsigned int GetWorkerCount() const { return (unsigned int)workers.size(); }
+
+	private:
+		struct WorkerQueue {
+			mutex lock;
+			deque<function<void()>> tasks;
+		};
+		void Run(unsigned int index);
+		bool TakeTask(unsigned int index, function<void()>& task);
+		// Index of the calling thread's queue, the shared queue for outside threads
+		unsigned int GetQueueIndex() const;
+		vector<thread> workers;
+		// One per worker, the last one is shared
+		vector<unique_ptr<WorkerQueue>> queues;
+		atomic<unsigned int> pending;
+		mutex sleepMutex;
+		condition_variable tasksAvailable;
+		bool stopping = false;
+	};
+}
+#endif
@@ -0,0 +1,75 @@
+#ifndef TWEEN_H
+#define TWEEN_H
+
+#include <vector>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+using namespace std;
+using namespace glm;
+
+typedef uint32_t TweenID;
+#define INVALID_TWEEN ((TweenID)0)
+
+namespace Engine {
+	enum class Easing : uint8_t { LINEAR, QUAD_IN, QUAD_OUT, QUAD_IN_OUT, CUBIC_OUT, BACK_OUT, BOUNCE_OUT, COUNT };
+
+	// Reported once a tween wrote its final value
+	struct TweenCompletion {
+		TweenID id;
+		// Whatever the caller passed to Add, e.g. a tile index
+		uint32_t tag;
+	};
+
+	// Animates floats, vec2s and vec4s owned by the caller. Tweens live in one set
+	// of parallel arrays per value type and easing curve, so Update runs one tight
+	// loop per group without virtual calls or a curve switch per tween. Finished
+	// tweens are swap-removed and listed in GetCompleted() until the next Update.
+	// Targets are raw pointers and must stay put while animated, Cancel first
+	// before moving or freeing them.
+	class TweenSystem
+	{
+	public:
+		// Moves *target from its current value to to over duration ms, after delay ms
+		TweenID Add(float* target, float to, float duration, Easing easing = Easing::QUAD_OUT, uint32_t tag = 0, float delay = 0);
+		TweenID Add(vec2* target, vec2 to, float duration, Easing easing = Easing::QUAD_OUT, uint32_t tag = 0, float delay = 0);
+		TweenID Add(vec4* target, vec4 to, float duration, Easing easing = Easing::QUAD_OUT, uint32_t tag = 0, float delay = 0);
+		// Stops every tween writing to target where it is, without a completion
+		void Cancel(const void* target);
+		void Clear();
+		// Advances every tween by deltaTime ms
+		void Update(float deltaTime);
+		const vector<TweenCompletion>& GetCompleted() const { return completed; }
+		size_t GetCount() const;
+		static float Ease(Easing easing, float t);
+
+	private:
+		template<class T>
+		struct TweenArray {
+			vector<T*> targets;
+			vector<T> from, delta;
+			// Starts at minus the delay
+			vector<float> time, invDuration;
+			vector<TweenID> ids;
+			vector<uint32_t> tags;
+		};
+		template<class T>
+		struct TweenGroups {
+			TweenArray<T> groups[(int)Easing::COUNT];
+		};
+		template<class T>
+		TweenID Insert(TweenGroups<T>& groups, T* target, T to, float duration, Easing easing, uint32_t tag, float delay);
+		template<class T, class F>
+		void Advance(TweenArray<T>& tweens, float deltaTime, F ease);
+		template<class T>
+		void Advance(TweenGroups<T>& groups, float deltaTime);
+		template<class T>
+		static void Remove(TweenArray<T>& tweens, size_t index);
+		TweenGroups<float> floats;
+		TweenGroups<vec2> vec2s;
+		TweenGroups<vec4> vec4s;
+		vector<TweenCompletion> completed;
+		TweenID nextID = 1;
+	};
+}
+#endif
@@ -0,0 +1,11 @@
+#version 330 core
+in vec2 Offset;
+in vec4 Tint;
+out vec4 color;
+
+void main()
+{
+	// Soft round dot, no texture needed
+	float falloff = max(1.0 - dot(Offset, Offset), 0.0);
+	color = vec4(Tint.rgb, Tint.a * falloff);
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#version 330 core
+layout (location = 0) in vec2 corner;
+layout (location = 1) in float x;
+layout (location = 2) in float y;
+layout (location = 3) in float size;
+layout (location = 4) in float life; // Age over lifetime, 0 to 1
+layout (location = 5) in vec4 tint;
+
+out vec2 Offset;
+out vec4 Tint;
+layout (std140) uniform Frame {
+	mat4 projection;
+};
+
+void main()
+{
+	gl_Position = projection * vec4(vec2(x, y) + (corner - 0.5) * size, 0.0, 1.0);
+	Offset = corner * 2.0 - 1.0;
+	// Fades out over its life
+	Tint = vec4(tint.rgb, tint.a * (1.0 - life));
+}
\ No newline at end of file
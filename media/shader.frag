@@ -1,16 +1,34 @@
 #version 330 core
 in vec2 TexCoords;
+in vec4 VertexColor;
 out vec4 color;
 
 uniform sampler2D ourTexture;
-uniform vec3 ourColor;
+// 1 for coverage text, 2 for distance field text
 uniform int text;
+// Distance field text only. Widths are fractions of the font's spread, 0 to 0.5 in total
+uniform vec4 outlineColor;
+uniform float outlineWidth;
+uniform vec4 glowColor;
+uniform float glowWidth;
 
 void main()
 {
 	if(text == 1){
 		vec4 sampled = vec4(1.0, 1.0, 1.0, texture(ourTexture, TexCoords).r);
-		color = vec4(ourColor, 1.0) * sampled;
+		color = VertexColor * sampled;
+	}else if(text == 2){
+		float distance = texture(ourTexture, TexCoords).r;
+		// About a screen pixel of antialiasing whatever the scale
+		float smoothing = max(fwidth(distance) * 0.75, 0.001);
+		float edge = 0.5 - outlineWidth;
+		float fill = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);
+		float shape = smoothstep(edge - smoothing, edge + smoothing, distance);
+		vec4 body = outlineWidth > 0.0 ? mix(outlineColor, VertexColor, fill) : VertexColor;
+		body.a *= shape;
+		float glow = glowWidth > 0.0 ? smoothstep(edge - glowWidth, edge, distance) * glowColor.a : 0.0;
+		float alpha = body.a + glow * (1.0 - body.a);
+		color = vec4((body.rgb * body.a + glowColor.rgb * glow * (1.0 - body.a)) / max(alpha, 0.001), alpha);
 	}else{	
 		color = texture(ourTexture, TexCoords);
 	}
@@ -1,12 +1,17 @@
 #version 330 core
 layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
+layout (location = 1) in vec4 vertexColor;
 
 out vec2 TexCoords;
-uniform mat4 projection;
+out vec4 VertexColor;
+layout (std140) uniform Frame {
+	mat4 projection;
+};
 uniform mat4 model;
 
 void main()
 {
 	gl_Position = projection * model *  vec4(vertex.xy, 0.0, 1.0);
 	TexCoords = vertex.zw;
+	VertexColor = vertexColor;
 }
\ No newline at end of file
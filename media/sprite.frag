@@ -0,0 +1,11 @@
+#version 330 core
+in vec2 TexCoords;
+in vec4 Tint;
+out vec4 color;
+
+uniform sampler2D ourTexture;
+
+void main()
+{
+	color = texture(ourTexture, TexCoords) * Tint;
+}
\ No newline at end of file
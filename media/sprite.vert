@@ -0,0 +1,18 @@
+#version 330 core
+layout (location = 0) in vec2 corner;
+layout (location = 1) in vec4 rect; // <vec2 pos, vec2 size>
+layout (location = 2) in vec4 uvRect; // <vec2 top left, vec2 bottom right>
+layout (location = 3) in vec4 tint;
+
+out vec2 TexCoords;
+out vec4 Tint;
+layout (std140) uniform Frame {
+	mat4 projection;
+};
+
+void main()
+{
+	gl_Position = projection * vec4(rect.xy + corner * rect.zw, 0.0, 1.0);
+	TexCoords = mix(uvRect.xy, uvRect.zw, corner);
+	Tint = tint;
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include "ActionRepeat.h"
+
+
+Engine::ActionRepeat::ActionRepeat(float delay, float interval, float debounce) : delay(delay), interval(interval), debounce(debounce)
+{
+	sinceTrigger = debounce;
+}
+
+bool Engine::ActionRepeat::Update(bool down, float deltaTime)
+{
+	sinceTrigger += deltaTime;
+
+	if (!down) {
+		held = false;
+		return false;
+	}
+
+	if (!held) {
+		// New press, unless it comes right after the last trigger: that is
+		// a bouncing contact, treat it as the same press still being held
+		held = true;
+		heldTime = 0;
+		nextRepeat = delay;
+		if (sinceTrigger < debounce) {
+			return false;
+		}
+		sinceTrigger = 0;
+		return true;
+	}
+
+	heldTime += deltaTime;
+	if (interval > 0 && heldTime >= nextRepeat) {
+		// Only one trigger per frame even after a long frame
+		while (nextRepeat <= heldTime) {
+			nextRepeat += interval;
+		}
+		sinceTrigger = 0;
+		return true;
+	}
+	return false;
+}
+
+void Engine::ActionRepeat::Reset()
+{
+	held = false;
+	heldTime = 0;
+	nextRepeat = 0;
+	sinceTrigger = debounce;
+}
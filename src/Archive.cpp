@@ -0,0 +1,123 @@
+#include "Archive.h"
+
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+Engine::Archive::Archive()
+{
+}
+
+
+Engine::Archive::~Archive()
+{
+	Close();
+}
+
+bool Engine::Archive::Open(const string& path)
+{
+	Close();
+
+#ifdef _WIN32
+	file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		file = nullptr;
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	GetFileSizeEx(file, &fileSize);
+	size = (size_t)fileSize.QuadPart;
+	mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == nullptr) {
+		Close();
+		return false;
+	}
+	data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat info;
+	if (fstat(fd, &info) != 0) {
+		close(fd);
+		return false;
+	}
+	size = (size_t)info.st_size;
+	void* mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping stays valid once the descriptor is closed
+	close(fd);
+	data = mapped == MAP_FAILED ? nullptr : (const unsigned char*)mapped;
+#endif
+	if (data == nullptr) {
+		Close();
+		return false;
+	}
+
+	// Written as differences, a damaged offset must not wrap the sum past the file size
+	const ArchiveHeader* header = (const ArchiveHeader*)data;
+	if (size < sizeof(ArchiveHeader) || header->magic != ARCHIVE_MAGIC || header->version != ARCHIVE_VERSION
+		|| header->indexOffset > size || (uint64_t)header->entryCount * sizeof(ArchiveEntry) > size - header->indexOffset) {
+		Close();
+		return false;
+	}
+	const ArchiveEntry* index = (const ArchiveEntry*)(data + header->indexOffset);
+	for (uint32_t i = 0; i < header->entryCount; i++) {
+		if (index[i].offset > size || index[i].size > size - index[i].offset) {
+			Close();
+			return false;
+		}
+		entries[string(index[i].name, strnlen(index[i].name, ARCHIVE_NAME_LENGTH))] = &index[i];
+	}
+	return true;
+}
+
+void Engine::Archive::Close()
+{
+	entries.clear();
+#ifdef _WIN32
+	if (data != nullptr) {
+		UnmapViewOfFile(data);
+	}
+	if (mapping != nullptr) {
+		CloseHandle(mapping);
+		mapping = nullptr;
+	}
+	if (file != nullptr) {
+		CloseHandle(file);
+		file = nullptr;
+	}
+#else
+	if (data != nullptr) {
+		munmap((void*)data, size);
+	}
+#endif
+	data = nullptr;
+	size = 0;
+}
+
+const Engine::ArchiveEntry* Engine::Archive::Find(const string& name) const
+{
+	auto it = entries.find(name);
+	if (it != entries.end()) {
+		return it->second;
+	}
+	return nullptr;
+}
+
+string Engine::Archive::FontEntryName(const string& fontPath, unsigned int pixelSize)
+{
+	return fontPath + "@" + to_string(pixelSize);
+}
+
+string Engine::Archive::SDFFontEntryName(const string& fontPath)
+{
+	return fontPath + "@sdf";
+}
@@ -0,0 +1,283 @@
+#include "AssetManager.h"
+#include "Profiler.h"
+
+#include <SOIL/SOIL.h>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+
+Engine::Image::~Image()
+{
+	if (pixels != nullptr && owned) {
+		SOIL_free_image_data((unsigned char*)pixels);
+	}
+}
+
+Engine::AssetManager::AssetManager()
+{
+}
+
+
+Engine::AssetManager::~AssetManager()
+{
+	// Copies still running write into mapped buffers, let them finish
+	for (Upload& upload : uploads) {
+		if (upload.copy.valid()) {
+			upload.copy.wait();
+		}
+	}
+}
+
+bool Engine::AssetManager::OpenArchive(const string& path)
+{
+	return archive.Open(path);
+}
+
+bool Engine::AssetManager::ReadText(const string& path, string& text, bool preferLoose) const
+{
+	const ArchiveEntry* entry = archive.Find(path);
+	if (entry != nullptr && !preferLoose) {
+		text.assign((const char*)archive.GetData(entry), (size_t)entry->size);
+		return true;
+	}
+	ifstream file(path, ios::binary);
+	if (!file) {
+		if (entry != nullptr) {
+			text.assign((const char*)archive.GetData(entry), (size_t)entry->size);
+			return true;
+		}
+		return false;
+	}
+	stringstream stream;
+	stream << file.rdbuf();
+	text = stream.str();
+	return true;
+}
+
+bool Engine::AssetManager::IsValidEntry(const ArchiveEntry* entry, uint64_t expectedSize)
+{
+	// Oversized dimensions are rejected too, so a wrapped expected size never passes
+	return entry->width > 0 && entry->height > 0 && entry->width <= ARCHIVE_MAX_DIMENSION && entry->height <= ARCHIVE_MAX_DIMENSION
+		&& entry->size == expectedSize;
+}
+
+shared_future<shared_ptr<Engine::Image>> Engine::AssetManager::LoadImage(const string& path)
+{
+	// Pre-decoded in the archive, nothing left to do
+	const ArchiveEntry* entry = archive.Find(path);
+	if (entry != nullptr && entry->type == ArchiveEntryType::IMAGE_RGBA && !IsValidEntry(entry, (uint64_t)entry->width * entry->height * 4)) {
+		cout << "Damaged image entry " << path << endl;
+		entry = nullptr;
+	}
+	if (entry != nullptr && entry->type == ArchiveEntryType::IMAGE_RGBA) {
+		shared_ptr<Image> image = make_shared<Image>();
+		image->width = entry->width;
+		image->height = entry->height;
+		image->pixels = archive.GetData(entry);
+		image->owned = false;
+		promise<shared_ptr<Image>> result;
+		result.set_value(image);
+		return result.get_future().share();
+	}
+
+	return ThreadPool::GetDefault().Async([path]() {
+		shared_ptr<Image> image = make_shared<Image>();
+		image->pixels = SOIL_load_image(path.c_str(), &image->width, &image->height, 0, SOIL_LOAD_RGBA);
+		if (image->pixels == nullptr) {
+			image = nullptr;
+		}
+		return image;
+	}).share();
+}
+
+shared_future<shared_ptr<Engine::FontBitmap>> Engine::AssetManager::LoadFont(const string& path, unsigned int pixelSize)
+{
+	const ArchiveEntry* entry = archive.Find(Archive::FontEntryName(path, pixelSize));
+	if (entry != nullptr && entry->type == ArchiveEntryType::FONT_ATLAS
+		&& !IsValidEntry(entry, sizeof(ArchiveGlyph) * FONT_NUM_GLYPHS + (uint64_t)entry->width * entry->height)) {
+		cout << "Damaged font entry " << Archive::FontEntryName(path, pixelSize) << endl;
+		entry = nullptr;
+	}
+	if (entry != nullptr && entry->type == ArchiveEntryType::FONT_ATLAS) {
+		const unsigned char* data = archive.GetData(entry);
+		return ThreadPool::GetDefault().Async([entry, data]() {
+			shared_ptr<FontBitmap> bitmap = make_shared<FontBitmap>();
+			const ArchiveGlyph* glyphs = (const ArchiveGlyph*)data;
+			for (int c = 0; c < FONT_NUM_GLYPHS; c++) {
+				Glyph& glyph = bitmap->glyphs[c];
+				glyph.Size = ivec2(glyphs[c].sizeX, glyphs[c].sizeY);
+				glyph.Bearing = ivec2(glyphs[c].bearingX, glyphs[c].bearingY);
+				glyph.Advance = glyphs[c].advance;
+				glyph.UV = vec4(glyphs[c].uv[0], glyphs[c].uv[1], glyphs[c].uv[2], glyphs[c].uv[3]);
+			}
+			bitmap->width = entry->width;
+			bitmap->height = entry->height;
+			bitmap->capHeight = bitmap->glyphs['H'].Bearing.y;
+			bitmap->pixelSize = entry->param;
+			const unsigned char* pixels = data + sizeof(ArchiveGlyph) * FONT_NUM_GLYPHS;
+			bitmap->pixels.assign(pixels, pixels + (size_t)entry->width * entry->height);
+			return bitmap;
+		}).share();
+	}
+
+	return ThreadPool::GetDefault().Async([path, pixelSize]() {
+		shared_ptr<FontBitmap> bitmap = make_shared<FontBitmap>();
+		string error;
+		if (!Font::Rasterize(path.c_str(), pixelSize, *bitmap, error)) {
+			cout << error << endl;
+			bitmap = nullptr;
+		}
+		return bitmap;
+	}).share();
+}
+
+shared_future<shared_ptr<Engine::FontBitmap>> Engine::AssetManager::LoadSDFFont(const string& path)
+{
+	// Baked by the packer, so installs with only the archive never need the font file
+	const ArchiveEntry* entry = archive.Find(Archive::SDFFontEntryName(path));
+	if (entry != nullptr && entry->type == ArchiveEntryType::FONT_SDF) {
+		const unsigned char* data = archive.GetData(entry);
+		return ThreadPool::GetDefault().Async([entry, data]() {
+			shared_ptr<FontBitmap> bitmap = make_shared<FontBitmap>();
+			uint64_t key;
+			if (!Font::ReadSDF(data, (size_t)entry->size, *bitmap, key)) {
+				cout << "Damaged font entry " << entry->name << endl;
+				bitmap = nullptr;
+			}
+			return bitmap;
+		}).share();
+	}
+
+	return ThreadPool::GetDefault().Async([path]() {
+		shared_ptr<FontBitmap> bitmap = make_shared<FontBitmap>();
+		string error;
+		if (!Font::LoadSDF(path.c_str(), *bitmap, error)) {
+			cout << error << endl;
+			bitmap = nullptr;
+		}
+		return bitmap;
+	}).share();
+}
+
+template<class T>
+Engine::AudioAsset<T> Engine::AssetManager::MakeAudioAsset(T* asset)
+{
+	// Must run on the decoding thread, Mix_GetError() is thread local
+	AudioAsset<T> result;
+	result.asset = asset;
+	if (asset == nullptr) {
+		result.error = Mix_GetError();
+	}
+	return result;
+}
+
+shared_future<Engine::AudioAsset<Mix_Music>> Engine::AssetManager::LoadMusic(const string& path)
+{
+	const ArchiveEntry* entry = archive.Find(path);
+	if (entry != nullptr && entry->type == ArchiveEntryType::AUDIO) {
+		const unsigned char* data = archive.GetData(entry);
+		int size = (int)entry->size;
+		return ThreadPool::GetDefault().Async([data, size]() {
+			return MakeAudioAsset(Mix_LoadMUS_RW(SDL_RWFromConstMem(data, size), 1));
+		}).share();
+	}
+
+	return ThreadPool::GetDefault().Async([path]() {
+		return MakeAudioAsset(Mix_LoadMUS(path.c_str()));
+	}).share();
+}
+
+shared_future<Engine::AudioAsset<Mix_Chunk>> Engine::AssetManager::LoadSound(const string& path)
+{
+	const ArchiveEntry* entry = archive.Find(path);
+	if (entry != nullptr && entry->type == ArchiveEntryType::AUDIO) {
+		const unsigned char* data = archive.GetData(entry);
+		int size = (int)entry->size;
+		return ThreadPool::GetDefault().Async([data, size]() {
+			return MakeAudioAsset(Mix_LoadWAV_RW(SDL_RWFromConstMem(data, size), 1));
+		}).share();
+	}
+
+	return ThreadPool::GetDefault().Async([path]() {
+		return MakeAudioAsset(Mix_LoadWAV(path.c_str()));
+	}).share();
+}
+
+shared_future<void> Engine::AssetManager::UploadTexture(shared_ptr<Image> image, GLuint texture, ivec2 offset)
+{
+	Upload upload = { image, texture, offset, 0, UploadStage::QUEUED, future<void>(), make_shared<promise<void>>() };
+	shared_future<void> done = upload.done->get_future().share();
+	uploads.push_back(move(upload));
+	return done;
+}
+
+void Engine::AssetManager::Update()
+{
+	PROFILE_SCOPE("AssetUploads");
+	size_t budget = ASSET_UPLOAD_BUDGET;
+
+	for (auto it = uploads.begin(); it != uploads.end();) {
+		Upload& upload = *it;
+		size_t size = (size_t)upload.image->width * upload.image->height * 4;
+
+		if (upload.stage == UploadStage::QUEUED) {
+			// Always start at least one upload so a huge image cannot block the queue
+			if (size > budget && budget != ASSET_UPLOAD_BUDGET) {
+				++it;
+				continue;
+			}
+			budget = size > budget ? 0 : budget - size;
+
+			// Map a fresh pixel buffer and let a worker fill it
+			void* dst = nullptr;
+			if (upload.image->owned) {
+				glGenBuffers(1, &upload.pbo);
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload.pbo);
+				glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+				dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+				if (dst == nullptr) {
+					glDeleteBuffers(1, &upload.pbo);
+				}
+			}
+
+			if (dst == nullptr) {
+				// Straight from the archive mapping there is no intermediate copy to make,
+				// and a pixel buffer that could not be mapped falls back to the same path
+				glBindTexture(GL_TEXTURE_2D, upload.texture);
+				glTexSubImage2D(GL_TEXTURE_2D, 0, upload.offset.x, upload.offset.y, upload.image->width, upload.image->height, GL_RGBA, GL_UNSIGNED_BYTE, upload.image->pixels);
+				glBindTexture(GL_TEXTURE_2D, 0);
+				Profiler::Get().CountUpload(size);
+				upload.done->set_value();
+				it = uploads.erase(it);
+				continue;
+			}
+
+			shared_ptr<Image> image = upload.image;
+			upload.copy = ThreadPool::GetDefault().Async([dst, image, size]() {
+				memcpy(dst, image->pixels, size);
+			});
+			upload.stage = UploadStage::COPYING;
+			++it;
+		}
+		else if (IsReady(upload.copy)) {
+			// Copy done, the driver transfers from the buffer without blocking us
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload.pbo);
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+			glBindTexture(GL_TEXTURE_2D, upload.texture);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, upload.offset.x, upload.offset.y, upload.image->width, upload.image->height, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)0);
+			glBindTexture(GL_TEXTURE_2D, 0);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			glDeleteBuffers(1, &upload.pbo);
+			Profiler::Get().CountUpload(size);
+
+			upload.done->set_value();
+			it = uploads.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+}
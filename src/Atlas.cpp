@@ -0,0 +1,33 @@
+#include "Atlas.h"
+
+
+Engine::AtlasPacker::AtlasPacker(int width, int height, int padding) : width(width), height(height), padding(padding)
+{
+}
+
+bool Engine::AtlasPacker::Pack(int w, int h, ivec2& position)
+{
+	int paddedW = w + padding;
+	int paddedH = h + padding;
+	if (paddedW > width) {
+		return false;
+	}
+
+	// Open a new shelf when the current one is full
+	if (shelfX + paddedW > width) {
+		shelfY += shelfHeight;
+		shelfX = 0;
+		shelfHeight = 0;
+	}
+
+	if (shelfY + paddedH > height) {
+		return false;
+	}
+
+	position = ivec2(shelfX, shelfY);
+	shelfX += paddedW;
+	if (paddedH > shelfHeight) {
+		shelfHeight = paddedH;
+	}
+	return true;
+}
@@ -0,0 +1,132 @@
+#include "Audio.h"
+
+
+Engine::Audio::Audio()
+{
+}
+
+
+Engine::Audio::~Audio()
+{
+	DeInit();
+}
+
+bool Engine::Audio::Init(int rate, int bufferSize, int voices, string& error)
+{
+	int flags = MIX_INIT_MP3 | MIX_INIT_FLAC | MIX_INIT_OGG;
+	if (flags != Mix_Init(flags)) {
+		error = "Unable to initialize mixer: " + string(Mix_GetError());
+		return false;
+	}
+
+	if (Mix_OpenAudio(rate, AUDIO_S16SYS, 2, bufferSize) != 0) {
+		error = "Unable to initialize audio: " + string(Mix_GetError());
+		return false;
+	}
+
+	Mix_AllocateChannels(voices);
+	this->voices.assign(voices, { INVALID_SOUND, 0, 0 });
+	initialized = true;
+	return true;
+}
+
+void Engine::Audio::DeInit()
+{
+	if (!initialized) {
+		return;
+	}
+	Mix_HaltChannel(-1);
+	Mix_HaltMusic();
+	for (Mix_Chunk* chunk : sounds) {
+		Mix_FreeChunk(chunk);
+	}
+	sounds.clear();
+	if (music != nullptr) {
+		Mix_FreeMusic(music);
+		music = nullptr;
+	}
+	Mix_CloseAudio();
+	Mix_Quit();
+	initialized = false;
+}
+
+SoundID Engine::Audio::AddSound(Mix_Chunk* chunk)
+{
+	if (chunk == nullptr) {
+		return INVALID_SOUND;
+	}
+	sounds.push_back(chunk);
+	return (SoundID)sounds.size() - 1;
+}
+
+int Engine::Audio::Play(SoundID sound, int priority, int volume)
+{
+	if (!initialized || sound < 0 || sound >= (SoundID)sounds.size()) {
+		return -1;
+	}
+
+	// A free voice, otherwise the least important and oldest one
+	int channel = -1;
+	for (int i = 0; i < (int)voices.size(); i++) {
+		if (Mix_Playing(i) == 0) {
+			channel = i;
+			break;
+		}
+		if (voices[i].priority > priority) {
+			continue;
+		}
+		if (channel == -1 || voices[i].priority < voices[channel].priority
+			|| (voices[i].priority == voices[channel].priority && voices[i].startedAt < voices[channel].startedAt)) {
+			channel = i;
+		}
+	}
+	if (channel == -1) {
+		return -1;
+	}
+
+	if (Mix_Playing(channel) != 0) {
+		Mix_HaltChannel(channel);
+	}
+	Mix_Volume(channel, volume);
+	if (Mix_PlayChannel(channel, sounds[sound], 0) == -1) {
+		return -1;
+	}
+	voices[channel] = { sound, priority, playCounter++ };
+	return channel;
+}
+
+void Engine::Audio::StopAll()
+{
+	Mix_HaltChannel(-1);
+}
+
+void Engine::Audio::SetMusic(Mix_Music* music)
+{
+	if (this->music != nullptr) {
+		Mix_HaltMusic();
+		Mix_FreeMusic(this->music);
+	}
+	this->music = music;
+}
+
+void Engine::Audio::PlayMusic(int loops)
+{
+	if (music != nullptr) {
+		Mix_PlayMusic(music, loops);
+	}
+}
+
+void Engine::Audio::PauseMusic()
+{
+	Mix_PauseMusic();
+}
+
+void Engine::Audio::ResumeMusic()
+{
+	Mix_ResumeMusic();
+}
+
+void Engine::Audio::StopMusic()
+{
+	Mix_HaltMusic();
+}
@@ -0,0 +1,186 @@
+#include "Board.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BOARD_USE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BOARD_USE_SSE2
+#endif
+
+
+unsigned int Engine::MatchMask::Count(int height) const
+{
+	unsigned int count = 0;
+	for (int y = 0; y < height; y++) {
+		count += PopCount(rows[y]);
+	}
+	return count;
+}
+
+Engine::Board::Board(int width, int height, int colours)
+{
+	Resize(width, height, colours);
+}
+
+void Engine::Board::Resize(int width, int height, int colours)
+{
+	this->width = width < BOARD_MAX_WIDTH ? width : BOARD_MAX_WIDTH;
+	this->height = height < BOARD_MAX_HEIGHT ? height : BOARD_MAX_HEIGHT;
+	this->colours = colours < BOARD_MAX_COLOURS ? colours : BOARD_MAX_COLOURS;
+	rowMask = this->width == 64 ? ~0ULL : (1ULL << this->width) - 1;
+	Clear();
+}
+
+void Engine::Board::Clear()
+{
+	memset(bits, 0, sizeof(bits));
+	memset(cells, BOARD_EMPTY, sizeof(cells));
+}
+
+void Engine::Board::Set(int x, int y, uint8_t colour)
+{
+	uint64_t bit = 1ULL << x;
+	if (cells[y][x] != BOARD_EMPTY) {
+		bits[y][cells[y][x]] &= ~bit;
+	}
+	cells[y][x] = colour;
+	if (colour != BOARD_EMPTY) {
+		bits[y][colour] |= bit;
+	}
+}
+
+void Engine::Board::Swap(int x1, int y1, int x2, int y2)
+{
+	uint8_t first = cells[y1][x1];
+	Set(x1, y1, cells[y2][x2]);
+	Set(x2, y2, first);
+}
+
+uint64_t Engine::Board::GetOccupied(int y) const
+{
+	uint64_t occupied = 0;
+	for (int c = 0; c < colours; c++) {
+		occupied |= bits[y][c];
+	}
+	return occupied;
+}
+
+void Engine::Board::ScanRowsScalar(int first, int last, uint64_t* horizontal, uint64_t* vertical) const
+{
+	for (int y = first; y < last; y++) {
+		uint64_t h = 0, v = 0;
+		for (int c = 0; c < colours; c++) {
+			uint64_t row = bits[y][c];
+			// Bit x survives if x, x + 1 and x + 2 are all set
+			uint64_t start = row & (row >> 1) & (row >> 2);
+			h |= start | (start << 1) | (start << 2);
+			if (y + 2 < height) {
+				v |= row & bits[y + 1][c] & bits[y + 2][c];
+			}
+		}
+		horizontal[y] = h;
+		vertical[y] = v;
+	}
+}
+
+void Engine::Board::ScanRowsSIMD(int first, int last, uint64_t* horizontal, uint64_t* vertical) const
+{
+#if defined(BOARD_USE_AVX2)
+	// Four colours per register, unused colours are all zero
+	for (int y = first; y < last; y++) {
+		__m256i h = _mm256_setzero_si256();
+		__m256i v = _mm256_setzero_si256();
+		for (int c = 0; c < BOARD_MAX_COLOURS; c += 4) {
+			__m256i row = _mm256_load_si256((const __m256i*)&bits[y][c]);
+			__m256i start = _mm256_and_si256(row, _mm256_and_si256(_mm256_srli_epi64(row, 1), _mm256_srli_epi64(row, 2)));
+			h = _mm256_or_si256(h, _mm256_or_si256(start, _mm256_or_si256(_mm256_slli_epi64(start, 1), _mm256_slli_epi64(start, 2))));
+			if (y + 2 < height) {
+				__m256i below = _mm256_load_si256((const __m256i*)&bits[y + 1][c]);
+				__m256i below2 = _mm256_load_si256((const __m256i*)&bits[y + 2][c]);
+				v = _mm256_or_si256(v, _mm256_and_si256(row, _mm256_and_si256(below, below2)));
+			}
+		}
+		// Merge the colour lanes
+		__m128i h2 = _mm_or_si128(_mm256_castsi256_si128(h), _mm256_extracti128_si256(h, 1));
+		__m128i v2 = _mm_or_si128(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+		h2 = _mm_or_si128(h2, _mm_unpackhi_epi64(h2, h2));
+		v2 = _mm_or_si128(v2, _mm_unpackhi_epi64(v2, v2));
+		_mm_storel_epi64((__m128i*)&horizontal[y], h2);
+		_mm_storel_epi64((__m128i*)&vertical[y], v2);
+	}
+#elif defined(BOARD_USE_SSE2)
+	// Two colours per register, unused colours are all zero
+	for (int y = first; y < last; y++) {
+		__m128i h = _mm_setzero_si128();
+		__m128i v = _mm_setzero_si128();
+		for (int c = 0; c < BOARD_MAX_COLOURS; c += 2) {
+			__m128i row = _mm_load_si128((const __m128i*)&bits[y][c]);
+			__m128i start = _mm_and_si128(row, _mm_and_si128(_mm_srli_epi64(row, 1), _mm_srli_epi64(row, 2)));
+			h = _mm_or_si128(h, _mm_or_si128(start, _mm_or_si128(_mm_slli_epi64(start, 1), _mm_slli_epi64(start, 2))));
+			if (y + 2 < height) {
+				__m128i below = _mm_load_si128((const __m128i*)&bits[y + 1][c]);
+				__m128i below2 = _mm_load_si128((const __m128i*)&bits[y + 2][c]);
+				v = _mm_or_si128(v, _mm_and_si128(row, _mm_and_si128(below, below2)));
+			}
+		}
+		// Merge the colour lanes
+		h = _mm_or_si128(h, _mm_unpackhi_epi64(h, h));
+		v = _mm_or_si128(v, _mm_unpackhi_epi64(v, v));
+		_mm_storel_epi64((__m128i*)&horizontal[y], h);
+		_mm_storel_epi64((__m128i*)&vertical[y], v);
+	}
+#else
+	ScanRowsScalar(first, last, horizontal, vertical);
+#endif
+}
+
+bool Engine::Board::ExpandMatches(const uint64_t* horizontal, const uint64_t* vertical, MatchMask& matches) const
+{
+	// A vertical run starting at row y covers rows y, y + 1 and y + 2. Merging the
+	// colours before expanding is fine since runs of different colours never touch
+	uint64_t any = 0;
+	for (int y = 0; y < height; y++) {
+		uint64_t row = horizontal[y] | vertical[y];
+		if (y >= 1) {
+			row |= vertical[y - 1];
+		}
+		if (y >= 2) {
+			row |= vertical[y - 2];
+		}
+		matches.rows[y] = row;
+		any |= row;
+	}
+	return any != 0;
+}
+
+bool Engine::Board::FindMatches(MatchMask& matches) const
+{
+	uint64_t horizontal[BOARD_MAX_HEIGHT], vertical[BOARD_MAX_HEIGHT];
+	ScanRowsSIMD(0, height, horizontal, vertical);
+	return ExpandMatches(horizontal, vertical, matches);
+}
+
+bool Engine::Board::FindMatches(MatchMask& matches, int firstRow, int lastRow, uint64_t columns) const
+{
+	uint64_t horizontal[BOARD_MAX_HEIGHT] = {}, vertical[BOARD_MAX_HEIGHT] = {};
+	// A vertical run reaching row firstRow may start two rows above it
+	int first = firstRow - 2 > 0 ? firstRow - 2 : 0;
+	int last = lastRow < height ? lastRow : height;
+	if (first >= last) {
+		memset(matches.rows, 0, sizeof(uint64_t) * height);
+		return false;
+	}
+	ScanRowsSIMD(first, last, horizontal, vertical);
+	for (int y = first; y < last; y++) {
+		vertical[y] &= columns;
+	}
+	return ExpandMatches(horizontal, vertical, matches);
+}
+
+bool Engine::Board::FindMatchesScalar(MatchMask& matches) const
+{
+	uint64_t horizontal[BOARD_MAX_HEIGHT], vertical[BOARD_MAX_HEIGHT];
+	ScanRowsScalar(0, height, horizontal, vertical);
+	return ExpandMatches(horizontal, vertical, matches);
+}
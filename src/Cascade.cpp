@@ -0,0 +1,91 @@
+#include "Cascade.h"
+
+
+Engine::CascadeResolver::CascadeResolver() : cleared(0)
+{
+	events.reserve(256);
+}
+
+int Engine::CascadeResolver::ResolveSwap(Board& board, Random& random, int x1, int y1, int x2, int y2)
+{
+	int first = y1 < y2 ? y1 : y2;
+	int last = (y1 > y2 ? y1 : y2) + 1;
+	return Resolve(board, random, first, last, (1ULL << x1) | (1ULL << x2));
+}
+
+int Engine::CascadeResolver::ResolveAll(Board& board, Random& random)
+{
+	return Resolve(board, random, 0, board.GetHeight(), board.GetRowMask());
+}
+
+int Engine::CascadeResolver::Resolve(Board& board, Random& random, int firstRow, int lastRow, uint64_t columns)
+{
+	events.clear();
+	cleared = 0;
+	MatchMask matches;
+	int lowest[BOARD_MAX_WIDTH];
+	int step = 0;
+	while (step < CASCADE_MAX_STEPS && board.FindMatches(matches, firstRow, lastRow, columns)) {
+		ClearMatches(board, matches, step, lowest);
+		// Gravity only moves pieces down, so everything that changed is above the lowest clear
+		columns = ApplyGravity(board, random, lowest, step, lastRow);
+		firstRow = 0;
+		step++;
+	}
+	return step;
+}
+
+void Engine::CascadeResolver::ClearMatches(Board& board, const MatchMask& matches, int step, int* lowest)
+{
+	for (int x = 0; x < board.GetWidth(); x++) {
+		lowest[x] = -1;
+	}
+	for (int y = 0; y < board.GetHeight(); y++) {
+		uint64_t row = matches.rows[y];
+		while (row) {
+			int x = LowestBit(row);
+			row &= row - 1;
+			events.push_back({ CASCADE_CLEARED, (uint8_t)step, board.Get(x, y), (uint8_t)x, (int8_t)y, (int8_t)y });
+			board.Set(x, y, BOARD_EMPTY);
+			lowest[x] = y;
+			cleared++;
+		}
+	}
+}
+
+uint64_t Engine::CascadeResolver::ApplyGravity(Board& board, Random& random, const int* lowest, int step, int& lastRow)
+{
+	uint64_t columns = 0;
+	lastRow = 0;
+	for (int x = 0; x < board.GetWidth(); x++) {
+		if (lowest[x] < 0) {
+			continue;
+		}
+		columns |= 1ULL << x;
+		if (lowest[x] + 1 > lastRow) {
+			lastRow = lowest[x] + 1;
+		}
+		// Walk up from the lowest hole, packing the remaining pieces at the bottom
+		int write = lowest[x];
+		for (int y = lowest[x]; y >= 0; y--) {
+			uint8_t colour = board.Get(x, y);
+			if (colour == BOARD_EMPTY) {
+				continue;
+			}
+			if (y != write) {
+				board.Set(x, write, colour);
+				board.Set(x, y, BOARD_EMPTY);
+				events.push_back({ CASCADE_FELL, (uint8_t)step, colour, (uint8_t)x, (int8_t)write, (int8_t)y });
+			}
+			write--;
+		}
+		// New pieces queue up above the board in the order they land
+		int spawned = write + 1;
+		for (int y = write; y >= 0; y--) {
+			uint8_t colour = (uint8_t)random.NextInt(board.GetColourCount());
+			board.Set(x, y, colour);
+			events.push_back({ CASCADE_SPAWNED, (uint8_t)step, colour, (uint8_t)x, (int8_t)y, (int8_t)(y - spawned) });
+		}
+	}
+	return columns;
+}
@@ -0,0 +1,417 @@
+#include "Font.h"
+#include "Atlas.h"
+#include "ProgramCache.h"
+#include "Archive.h"
+
+#include <ft2build.h>
+#include <freetype/freetype.h>
+#include <cstring>
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+
+// Squared distance standing in for "no seed pixel yet"
+#define SDF_INFINITY 1e20f
+
+struct FontCacheHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t key;
+	uint32_t width, height;
+	int32_t capHeight;
+	uint32_t pixelSize;
+};
+
+// Copies the packed glyphs into one atlas trimmed to a power of two height
+static void FillAtlas(const Engine::AtlasPacker& packer, const ivec2* positions, const vector<unsigned char>* glyphPixels, Engine::FontBitmap& bitmap)
+{
+	bitmap.width = FONT_ATLAS_WIDTH;
+	bitmap.height = 1;
+	while (bitmap.height < packer.GetUsedHeight()) {
+		bitmap.height *= 2;
+	}
+	bitmap.pixels.assign(bitmap.width * bitmap.height, 0);
+
+	for (int c = 0; c < FONT_NUM_GLYPHS; c++) {
+		Engine::Glyph& glyph = bitmap.glyphs[c];
+		for (int row = 0; row < glyph.Size.y; row++) {
+			memcpy(&bitmap.pixels[(positions[c].y + row) * bitmap.width + positions[c].x], &glyphPixels[c][row * glyph.Size.x], glyph.Size.x);
+		}
+		glyph.UV = vec4(
+			(float)positions[c].x / bitmap.width,
+			(float)positions[c].y / bitmap.height,
+			(float)(positions[c].x + glyph.Size.x) / bitmap.width,
+			(float)(positions[c].y + glyph.Size.y) / bitmap.height);
+	}
+}
+
+// Felzenszwalb and Huttenlocher: squared distance to the nearest seed along one line.
+// f holds 0 on seeds and SDF_INFINITY elsewhere, v and z are scratch of n and n + 1
+static void DistanceTransform1D(const float* f, float* d, int n, int* v, float* z)
+{
+	int k = 0;
+	v[0] = 0;
+	z[0] = -SDF_INFINITY;
+	z[1] = SDF_INFINITY;
+	for (int q = 1; q < n; q++) {
+		float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+		while (s <= z[k]) {
+			k--;
+			s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+		}
+		k++;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1] = SDF_INFINITY;
+	}
+	k = 0;
+	for (int q = 0; q < n; q++) {
+		while (z[k + 1] < q) {
+			k++;
+		}
+		d[q] = (float)((q - v[k]) * (q - v[k])) + f[v[k]];
+	}
+}
+
+// Exact squared euclidean distance to the nearest seed, columns then rows
+static void DistanceTransform(vector<float>& grid, int width, int height)
+{
+	int n = width > height ? width : height;
+	vector<float> f(n), d(n), z(n + 1);
+	vector<int> v(n);
+	for (int x = 0; x < width; x++) {
+		for (int y = 0; y < height; y++) {
+			f[y] = grid[y * width + x];
+		}
+		DistanceTransform1D(f.data(), d.data(), height, v.data(), z.data());
+		for (int y = 0; y < height; y++) {
+			grid[y * width + x] = d[y];
+		}
+	}
+	for (int y = 0; y < height; y++) {
+		DistanceTransform1D(&grid[y * width], d.data(), width, v.data(), z.data());
+		memcpy(&grid[y * width], d.data(), width * sizeof(float));
+	}
+}
+
+
+Engine::Font::Font()
+{
+}
+
+
+Engine::Font::~Font()
+{
+	if (texture != 0) {
+		glDeleteTextures(1, &texture);
+	}
+}
+
+bool Engine::Font::Rasterize(const char* fontPath, unsigned int pixelSize, FontBitmap& bitmap, string& error)
+{
+	// Init Freetype
+	FT_Library ft;
+	if (FT_Init_FreeType(&ft)) {
+		error = "ERROR::FREETYPE: Could not init FreeType Library";
+		return false;
+	}
+	FT_Face face;
+	if (FT_New_Face(ft, fontPath, 0, &face)) {
+		FT_Done_FreeType(ft);
+		error = "ERROR::FREETYPE: Failed to load font";
+		return false;
+	}
+
+	FT_Set_Pixel_Sizes(face, 0, pixelSize);
+
+	// Glyph bitmaps are kept until we know where they go in the atlas
+	vector<unsigned char> glyphPixels[FONT_NUM_GLYPHS];
+	AtlasPacker packer(FONT_ATLAS_WIDTH, FONT_ATLAS_WIDTH * 4);
+	ivec2 positions[FONT_NUM_GLYPHS];
+
+	for (int c = 0; c < FONT_NUM_GLYPHS; c++)
+	{
+		Glyph& glyph = bitmap.glyphs[c];
+		glyph = Glyph();
+		// Load character glyph
+		if (FT_Load_Char(face, c, FT_LOAD_RENDER))
+		{
+			cout << "ERROR::FREETYTPE: Failed to load Glyph" << endl;
+			continue;
+		}
+		FT_GlyphSlot slot = face->glyph;
+		glyph.Size = ivec2(slot->bitmap.width, slot->bitmap.rows);
+		glyph.Bearing = ivec2(slot->bitmap_left, slot->bitmap_top);
+		glyph.Advance = (GLuint)(slot->advance.x >> 6); // Bitshift by 6 to get value in pixels(2 ^ 6 = 64)
+
+		if (!packer.Pack(glyph.Size.x, glyph.Size.y, positions[c])) {
+			FT_Done_Face(face);
+			FT_Done_FreeType(ft);
+			error = "ERROR::FREETYPE: Glyph atlas is full";
+			return false;
+		}
+
+		// Bitmap rows may be padded, copy them tightly
+		glyphPixels[c].resize(glyph.Size.x * glyph.Size.y);
+		for (int row = 0; row < glyph.Size.y; row++) {
+			memcpy(&glyphPixels[c][row * glyph.Size.x], slot->bitmap.buffer + row * slot->bitmap.pitch, glyph.Size.x);
+		}
+	}
+
+	FT_Done_Face(face);
+	FT_Done_FreeType(ft);
+
+	FillAtlas(packer, positions, glyphPixels, bitmap);
+	bitmap.capHeight = bitmap.glyphs['H'].Bearing.y;
+	bitmap.pixelSize = pixelSize;
+	bitmap.sdf = false;
+
+	return true;
+}
+
+bool Engine::Font::RasterizeSDF(const char* fontPath, unsigned int pixelSize, unsigned int spread, FontBitmap& bitmap, string& error)
+{
+	FT_Library ft;
+	if (FT_Init_FreeType(&ft)) {
+		error = "ERROR::FREETYPE: Could not init FreeType Library";
+		return false;
+	}
+	FT_Face face;
+	if (FT_New_Face(ft, fontPath, 0, &face)) {
+		FT_Done_FreeType(ft);
+		error = "ERROR::FREETYPE: Failed to load font";
+		return false;
+	}
+
+	const int scale = FONT_SDF_OVERSAMPLE;
+	FT_Set_Pixel_Sizes(face, 0, pixelSize * scale);
+
+	vector<unsigned char> glyphPixels[FONT_NUM_GLYPHS];
+	AtlasPacker packer(FONT_ATLAS_WIDTH, FONT_ATLAS_WIDTH * 4);
+	ivec2 positions[FONT_NUM_GLYPHS];
+	vector<float> outside, inside;
+
+	for (int c = 0; c < FONT_NUM_GLYPHS; c++)
+	{
+		Glyph& glyph = bitmap.glyphs[c];
+		glyph = Glyph();
+		if (FT_Load_Char(face, c, FT_LOAD_RENDER))
+		{
+			cout << "ERROR::FREETYTPE: Failed to load Glyph" << endl;
+			continue;
+		}
+		FT_GlyphSlot slot = face->glyph;
+		// Rounded to the nearest pixel at the final size
+		glyph.Advance = (GLuint)(((slot->advance.x >> 6) + scale / 2) / scale);
+		int w = slot->bitmap.width, h = slot->bitmap.rows;
+		if (w == 0 || h == 0) {
+			// Blank, like the space
+			positions[c] = ivec2(0, 0);
+			continue;
+		}
+
+		// The field covers the glyph plus the spread, on a grid whose cells line up
+		// with whole pixels of the final glyph so the bearings stay integers
+		int pad = spread * scale;
+		int left = (int)floor((float)(slot->bitmap_left - pad) / scale);
+		int top = (int)ceil((float)(slot->bitmap_top + pad) / scale);
+		int offsetX = slot->bitmap_left - left * scale;
+		int offsetY = top * scale - slot->bitmap_top;
+		int sizeX = (offsetX + w + pad + scale - 1) / scale;
+		int sizeY = (offsetY + h + pad + scale - 1) / scale;
+		int gridW = sizeX * scale, gridH = sizeY * scale;
+
+		// Distances to the nearest inside pixel and to the nearest outside pixel
+		outside.assign(gridW * gridH, SDF_INFINITY);
+		inside.assign(gridW * gridH, 0.0f);
+		for (int row = 0; row < h; row++) {
+			const unsigned char* src = slot->bitmap.buffer + row * slot->bitmap.pitch;
+			for (int col = 0; col < w; col++) {
+				if (src[col] >= 128) {
+					size_t i = (size_t)(offsetY + row) * gridW + offsetX + col;
+					outside[i] = 0;
+					inside[i] = SDF_INFINITY;
+				}
+			}
+		}
+		DistanceTransform(outside, gridW, gridH);
+		DistanceTransform(inside, gridW, gridH);
+
+		glyph.Size = ivec2(sizeX, sizeY);
+		glyph.Bearing = ivec2(left, top);
+		glyphPixels[c].resize(sizeX * sizeY);
+		for (int y = 0; y < sizeY; y++) {
+			for (int x = 0; x < sizeX; x++) {
+				// Average of the oversampled cells, half a cell in from the pixel centres to the edge
+				float sum = 0;
+				for (int sy = 0; sy < scale; sy++) {
+					for (int sx = 0; sx < scale; sx++) {
+						size_t i = (size_t)(y * scale + sy) * gridW + x * scale + sx;
+						sum += outside[i] > 0 ? sqrt(outside[i]) - 0.5f : 0.5f - sqrt(inside[i]);
+					}
+				}
+				float distance = sum / (scale * scale) / scale;
+				float value = 0.5f - distance / (2.0f * spread);
+				value = value < 0 ? 0 : (value > 1 ? 1 : value);
+				glyphPixels[c][y * sizeX + x] = (unsigned char)(value * 255 + 0.5f);
+			}
+		}
+
+		if (!packer.Pack(sizeX, sizeY, positions[c])) {
+			FT_Done_Face(face);
+			FT_Done_FreeType(ft);
+			error = "ERROR::FREETYPE: Glyph atlas is full";
+			return false;
+		}
+	}
+
+	FT_Done_Face(face);
+	FT_Done_FreeType(ft);
+
+	FillAtlas(packer, positions, glyphPixels, bitmap);
+	// The padded bearing reaches spread pixels above the real top line
+	bitmap.capHeight = bitmap.glyphs['H'].Bearing.y - (int)spread;
+	bitmap.pixelSize = pixelSize;
+	bitmap.sdf = true;
+
+	return true;
+}
+
+uint64_t Engine::Font::MakeSDFKey(const void* fontData, size_t size)
+{
+	// The font file and everything that shapes the field
+	unsigned int params[] = { FONT_SDF_SIZE, FONT_SDF_SPREAD, FONT_SDF_OVERSAMPLE, FONT_ATLAS_WIDTH };
+	uint64_t key = ProgramCache::Hash(fontData, size);
+	return ProgramCache::Hash(params, sizeof(params), key);
+}
+
+bool Engine::Font::ReadSDF(const unsigned char* data, size_t size, FontBitmap& bitmap, uint64_t& key)
+{
+	FontCacheHeader header;
+	ArchiveGlyph glyphs[FONT_NUM_GLYPHS];
+	if (size < sizeof(header) + sizeof(glyphs)) {
+		return false;
+	}
+	memcpy(&header, data, sizeof(header));
+	// A damaged file must never decide how much gets allocated
+	if (header.magic != FONT_CACHE_MAGIC || header.version != FONT_CACHE_VERSION || header.width != FONT_ATLAS_WIDTH
+		|| header.height == 0 || header.height > FONT_ATLAS_WIDTH * 4 || size != sizeof(header) + sizeof(glyphs) + (size_t)header.width * header.height) {
+		return false;
+	}
+	memcpy(glyphs, data + sizeof(header), sizeof(glyphs));
+	for (int c = 0; c < FONT_NUM_GLYPHS; c++) {
+		Glyph& glyph = bitmap.glyphs[c];
+		glyph.Size = ivec2(glyphs[c].sizeX, glyphs[c].sizeY);
+		glyph.Bearing = ivec2(glyphs[c].bearingX, glyphs[c].bearingY);
+		glyph.Advance = glyphs[c].advance;
+		glyph.UV = vec4(glyphs[c].uv[0], glyphs[c].uv[1], glyphs[c].uv[2], glyphs[c].uv[3]);
+	}
+	const unsigned char* pixels = data + sizeof(header) + sizeof(glyphs);
+	bitmap.pixels.assign(pixels, pixels + (size_t)header.width * header.height);
+	bitmap.width = header.width;
+	bitmap.height = header.height;
+	bitmap.capHeight = header.capHeight;
+	bitmap.pixelSize = header.pixelSize;
+	bitmap.sdf = true;
+	key = header.key;
+	return true;
+}
+
+void Engine::Font::WriteSDF(const FontBitmap& bitmap, uint64_t key, vector<unsigned char>& data)
+{
+	FontCacheHeader header = { FONT_CACHE_MAGIC, FONT_CACHE_VERSION, key, (uint32_t)bitmap.width, (uint32_t)bitmap.height, bitmap.capHeight, bitmap.pixelSize };
+	ArchiveGlyph glyphs[FONT_NUM_GLYPHS];
+	for (int c = 0; c < FONT_NUM_GLYPHS; c++) {
+		const Glyph& glyph = bitmap.glyphs[c];
+		glyphs[c] = { glyph.Size.x, glyph.Size.y, glyph.Bearing.x, glyph.Bearing.y, glyph.Advance,
+			{ glyph.UV.x, glyph.UV.y, glyph.UV.z, glyph.UV.w } };
+	}
+	data.assign((const unsigned char*)&header, (const unsigned char*)&header + sizeof(header));
+	data.insert(data.end(), (const unsigned char*)glyphs, (const unsigned char*)glyphs + sizeof(glyphs));
+	data.insert(data.end(), bitmap.pixels.begin(), bitmap.pixels.end());
+}
+
+bool Engine::Font::LoadSDF(const char* fontPath, FontBitmap& bitmap, string& error)
+{
+	ifstream source(fontPath, ios::binary);
+	if (!source) {
+		error = "ERROR::FREETYPE: Failed to load font";
+		return false;
+	}
+	string bytes((istreambuf_iterator<char>(source)), istreambuf_iterator<char>());
+	uint64_t key = MakeSDFKey(bytes.data(), bytes.size());
+
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.sdf", (unsigned long long)key);
+	string path = string(FONT_CACHE_DIR) + "/" + name;
+
+	// Anything larger than the biggest possible atlas is not ours, it gets regenerated
+	ifstream file(path, ios::binary | ios::ate);
+	if (file) {
+		size_t size = (size_t)file.tellg();
+		size_t largest = sizeof(FontCacheHeader) + sizeof(ArchiveGlyph) * FONT_NUM_GLYPHS + (size_t)FONT_ATLAS_WIDTH * FONT_ATLAS_WIDTH * 4;
+		vector<unsigned char> data(size <= largest ? size : 0);
+		uint64_t storedKey;
+		if (!data.empty() && file.seekg(0) && file.read((char*)data.data(), data.size())
+			&& ReadSDF(data.data(), data.size(), bitmap, storedKey) && storedKey == key) {
+			return true;
+		}
+	}
+	file.close();
+
+	if (!RasterizeSDF(fontPath, FONT_SDF_SIZE, FONT_SDF_SPREAD, bitmap, error)) {
+		return false;
+	}
+
+	// Written next to the shader cache the same way, a failed write only costs the next start
+	error_code ec;
+	filesystem::create_directories(FONT_CACHE_DIR, ec);
+	string tempPath = path + ".tmp";
+	{
+		ofstream out(tempPath, ios::binary | ios::trunc);
+		if (!out) {
+			return true;
+		}
+		vector<unsigned char> data;
+		WriteSDF(bitmap, key, data);
+		out.write((const char*)data.data(), data.size());
+		if (!out) {
+			return true;
+		}
+	}
+	filesystem::rename(tempPath, path, ec);
+	return true;
+}
+
+void Engine::Font::Upload(const FontBitmap& bitmap)
+{
+	memcpy(glyphs, bitmap.glyphs, sizeof(glyphs));
+	capHeight = bitmap.capHeight;
+	pixelSize = bitmap.pixelSize;
+	sdf = bitmap.sdf;
+
+	if (texture == 0) {
+		glGenTextures(1, &texture);
+	}
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Disable byte-alignment restriction
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, bitmap.width, bitmap.height, 0, GL_RED, GL_UNSIGNED_BYTE, bitmap.pixels.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	// Set texture options
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+bool Engine::Font::Load(const char* fontPath, unsigned int pixelSize, string& error)
+{
+	FontBitmap bitmap;
+	if (!Rasterize(fontPath, pixelSize, bitmap, error)) {
+		return false;
+	}
+	Upload(bitmap);
+	return true;
+}
@@ -0,0 +1,73 @@
+#include "FramePacer.h"
+
+
+Engine::FramePacer::FramePacer()
+{
+}
+
+
+Engine::FramePacer::~FramePacer()
+{
+}
+
+void Engine::FramePacer::Init(unsigned int targetFrameRate)
+{
+	frequency = SDL_GetPerformanceFrequency();
+	start = SDL_GetPerformanceCounter();
+	lastFrame = start;
+	targetFrameTime = targetFrameRate > 0 ? 1000.0 / targetFrameRate : 0;
+	deadline = targetFrameTime;
+	ResetStats();
+}
+
+double Engine::FramePacer::Now() const
+{
+	return (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+}
+
+double Engine::FramePacer::BeginFrame()
+{
+	Uint64 now = SDL_GetPerformanceCounter();
+	double delta = (double)(now - lastFrame) * 1000.0 / frequency;
+	lastFrame = now;
+
+	sampleCount++;
+	double difference = delta - mean;
+	mean += difference / sampleCount;
+	m2 += difference * (delta - mean);
+	if (delta > maxFrameTime) {
+		maxFrameTime = delta;
+	}
+	return delta;
+}
+
+void Engine::FramePacer::EndFrame()
+{
+	if (targetFrameTime <= 0) {
+		return;
+	}
+
+	// Sleep off most of what is left, then spin for the last bit
+	double remaining = deadline - Now();
+	if (remaining > FRAMEPACER_SPIN_THRESHOLD + 0.5) {
+		SDL_Delay((Uint32)(remaining - FRAMEPACER_SPIN_THRESHOLD + 0.5));
+	}
+	while (Now() < deadline) {
+	}
+
+	// Deadlines advance by exactly one frame so rounding never adds up, but
+	// a frame that ran late does not make the following ones rush to catch up
+	deadline += targetFrameTime;
+	double now = Now();
+	if (deadline < now) {
+		deadline = now + targetFrameTime;
+	}
+}
+
+void Engine::FramePacer::ResetStats()
+{
+	sampleCount = 0;
+	mean = 0;
+	m2 = 0;
+	maxFrameTime = 0;
+}
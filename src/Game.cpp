@@ -22,10 +22,6 @@ void Engine::Game::Start(string windowTitle, unsigned int screenWidth, unsigned
 	this->screenHeight = screenHeight;
 	this->timeScale = timeScale;
 
-	if (targetFrameRate > 0) {
-		targetFrameTime = 1000.0f / targetFrameRate;
-	}
-
 
 	Uint32 flags = SDL_WINDOW_OPENGL;
 
@@ -62,59 +58,264 @@ void Engine::Game::Start(string windowTitle, unsigned int screenWidth, unsigned
 	//Set VSYNC
 	SDL_GL_SetSwapInterval(vsync);
 
+	// Packed assets when available, loose files otherwise
+	assets.OpenArchive(ARCHIVE_NAME);
+
+	InitFrameUniforms();
+	programCache.Init();
+	Profiler::Get().InitGpu();
+
 	this->state = State::RUNNING;
 
 	Init();
+	BeginPipeline();
 
 	// Init delta time calculation
-	last = SDL_GetTicks();
+	framePacer.Init(targetFrameRate);
+	lastFPSUpdate = 0;
 
 	//Will loop until we set _gameState to EXIT
+	Profiler& profiler = Profiler::Get();
 	while (State::RUNNING == state) {
+		profiler.BeginFrame();
+		ReloadShaders();
 		float deltaTime = GetDeltaTime();
+		if (replay.IsPlaying() && !replay.NextFrame(deltaTime, replayEvents)) {
+			// The recording is over
+			Quit();
+			profiler.EndFrame();
+			continue;
+		}
+		recorder.BeginFrame(deltaTime);
 		GetFPS();
-		PollInput();
-		Update(deltaTime);
-		Render();
-		SDL_GL_SwapWindow(window);
-		LimitFPS();
+		{
+			PROFILE_SCOPE("PollInput");
+			PollInput();
+		}
+		assets.Update();
+		future<void> update = BeginUpdate(deltaTime);
+		RenderFrame();
+		{
+			PROFILE_SCOPE("SwapWindow");
+			SDL_GL_SwapWindow(window);
+		}
+		EndUpdate(update);
+		{
+			PROFILE_SCOPE("LimitFPS");
+			LimitFPS();
+		}
 		PrintFPS();
+		profiler.EndFrame();
+		frameCount++;
 	}
 
 	DeInit();
+	shaderWatcher.Stop();
+	recorder.Close();
+	replay.Close();
 
 }
 
+float Engine::Game::Simulate(float deltaTime)
+{
+	if (fixedTimestep > 0) {
+		// Simulation advances in fixed steps, Render() interpolates between them
+		accumulator += deltaTime;
+		if (accumulator > fixedTimestep * MAX_FIXED_STEPS) {
+			accumulator = fixedTimestep * MAX_FIXED_STEPS;
+		}
+		while (accumulator >= fixedTimestep) {
+			Update(fixedTimestep);
+			accumulator -= fixedTimestep;
+		}
+		return accumulator / fixedTimestep;
+	}
+	Update(deltaTime);
+	return 0;
+}
 
-float Engine::Game::GetDeltaTime()
+void Engine::Game::BeginPipeline()
+{
+	if (!pipelined) {
+		return;
+	}
+	// The first frame draws what Init() left behind
+	renderBuffer = 0;
+	snapshotAlpha[0] = snapshotAlpha[1] = interpolationAlpha;
+	PrepareRender(renderBuffer);
+	if (!pipelineHooks) {
+		cout << "PrepareRender() is not overridden, rendering without the pipeline" << endl;
+		pipelined = false;
+	}
+}
+
+future<void> Engine::Game::BeginUpdate(float deltaTime)
 {
-	unsigned int time = SDL_GetTicks();
-	unsigned int delta = time - lastFrame;
-	lastFrame = time;
+	if (!pipelined) {
+		PROFILE_SCOPE("Update");
+		interpolationAlpha = Simulate(deltaTime);
+		return future<void>();
+	}
+	// Written before the worker starts, so while it runs both threads only read it
+	interpolationAlpha = snapshotAlpha[renderBuffer];
+	// The next frame is simulated into the other buffer while this one is drawn
+	unsigned int updateBuffer = renderBuffer ^ 1;
+	return ThreadPool::GetDefault().Async([this, deltaTime, updateBuffer]() {
+		PROFILE_SCOPE("Update");
+		snapshotAlpha[updateBuffer] = Simulate(deltaTime);
+		PrepareRender(updateBuffer);
+	});
+}
 
-	return delta * timeScale;
+void Engine::Game::RenderFrame()
+{
+	PROFILE_SCOPE("Render");
+	PROFILE_GPU_SCOPE("Render");
+	UploadFrameUniforms();
+	if (pipelined) {
+		RenderPrepared(renderBuffer);
+	}
+	else {
+		Render();
+	}
+	renderQueue.Execute(stateCache);
+}
+
+void Engine::Game::EndUpdate(future<void>& update)
+{
+	if (!update.valid()) {
+		return;
+	}
+	// Input and the next frame's buffers may only be touched once the update is done
+	PROFILE_SCOPE("WaitUpdate");
+	ThreadPool::GetDefault().Wait(update);
+	update.get();
+	renderBuffer ^= 1;
+}
+
+void Engine::Game::PrepareRender(unsigned int buffer)
+{
+	pipelineHooks = false;
+}
+
+void Engine::Game::RenderPrepared(unsigned int buffer)
+{
+	Err("Pipelined games must override RenderPrepared");
+}
+
+bool Engine::Game::RunHeadless(unsigned int frames, float deltaTime)
+{
+	// No SDL subsystems, so any number of games can run side by side on the workers
+	headless = true;
+	frameCount = 0;
+	this->state = State::RUNNING;
+
+	if (!InitHeadless()) {
+		recorder.Close();
+		replay.Close();
+		return false;
+	}
+
+	while (State::RUNNING == state && frameCount < frames) {
+		float frameDelta = deltaTime;
+		if (replay.IsPlaying() && !replay.NextFrame(frameDelta, replayEvents)) {
+			break;
+		}
+		recorder.BeginFrame(frameDelta);
+		_previousKeyState = _keyState;
+		ApplyReplayEvents();
+		interpolationAlpha = Simulate(frameDelta);
+		frameCount++;
+	}
+	recorder.Close();
+	replay.Close();
+	return true;
+}
+
+bool Engine::Game::StartRecording(const string& path, uint64_t seed)
+{
+	if (!recorder.Open(path, seed)) {
+		return false;
+	}
+	random.Seed(seed);
+	return true;
+}
+
+bool Engine::Game::StartReplay(const string& path)
+{
+	if (!replay.Open(path)) {
+		return false;
+	}
+	random.Seed(replay.GetSeed());
+	return true;
+}
+
+unsigned int Engine::Game::RunHeadlessBatch(unsigned int count, unsigned int frames, float deltaTime, function<unique_ptr<Game>(unsigned int)> create,
+	function<void(unsigned int, Game&)> finished, ThreadPool& pool)
+{
+	vector<future<bool>> runs;
+	runs.reserve(count);
+	for (unsigned int i = 0; i < count; i++) {
+		runs.push_back(pool.Async([i, frames, deltaTime, &create, &finished]() {
+			unique_ptr<Game> game = create(i);
+			if (!game->RunHeadless(frames, deltaTime)) {
+				return false;
+			}
+			if (finished) {
+				finished(i, *game);
+			}
+			return true;
+		}));
+	}
+	// The calling thread helps instead of idling
+	unsigned int failed = 0;
+	for (future<bool>& run : runs) {
+		pool.Wait(run);
+		if (!run.get()) {
+			failed++;
+		}
+	}
+	return failed;
+}
+
+
+float Engine::Game::GetDeltaTime()
+{
+	return (float)framePacer.BeginFrame() * timeScale;
 }
 
 void Engine::Game::GetFPS()
 {
-	if (SDL_GetTicks() - last > 1000) {
+	if (framePacer.Now() - lastFPSUpdate > 1000) {
 		fps = _fps;
 		_fps = 0;
-		last += 1000;
+		lastFPSUpdate += 1000;
 	}
 	_fps++;
 }
 
 void Engine::Game::PrintFPS() {
 	//print only once every 60 frames
-	static int frameCounter = 0;
-	frameCounter++;
-	if (frameCounter == 60) {
-		cout << "FPS: " << fps << endl;
-		frameCounter = 0;
+	if (framePacer.GetSampleCount() >= 60) {
+		cout << "FPS: " << fps << " | frame " << framePacer.GetFrameTimeMean() << " ms, stddev "
+			<< sqrt(framePacer.GetFrameTimeVariance()) << " ms, max " << framePacer.GetFrameTimeMax() << " ms" << endl;
+		framePacer.ResetStats();
 	}
 }
 
+void Engine::Game::SetPipelined(bool enabled)
+{
+	pipelined = enabled;
+}
+
+void Engine::Game::SetFixedTimestep(float stepMs)
+{
+	fixedTimestep = stepMs;
+	accumulator = 0;
+	interpolationAlpha = 0;
+	snapshotAlpha[0] = snapshotAlpha[1] = 0;
+}
+
 void Engine::Game::OpenGameController()
 {
 	if (SDL_NumJoysticks() > 0) {
@@ -140,8 +341,15 @@ void Engine::Game::PollInput()
 {
 	SDL_Event evt;
 
+	// Last frame's state is what edge detection compares against
+	_previousKeyState = _keyState;
+
 	//Will keep looping until there are no more events to process
 	while (SDL_PollEvent(&evt)) {
+		// A replay only takes its input from the log, closing the window still works
+		if (replay.IsPlaying() && evt.type != SDL_QUIT) {
+			continue;
+		}
 		switch (evt.type) {
 		case SDL_QUIT:
 			state = State::EXIT;
@@ -175,73 +383,71 @@ void Engine::Game::PollInput()
 			break;
 		}
 	}
+	ApplyReplayEvents();
+}
+
+void Engine::Game::ApplyReplayEvents()
+{
+	for (const InputEvent& event : replayEvents) {
+		switch (event.type) {
+		case INPUT_PRESS:
+			PressKey(event.key);
+			break;
+		case INPUT_RELEASE:
+			ReleaseKey(event.key);
+			break;
+		case INPUT_MOUSE:
+			SetMouseCoords((float)event.x, (float)event.y);
+			break;
+		}
+	}
+	replayEvents.clear();
 }
 
 void Engine::Game::PressKey(unsigned int keyID) {
-	// Here we are treating _keyMap as an associative array.
-	// if keyID doesn't already exist in _keyMap, it will get added
-	auto it = _mapNames.find(keyID);
-	if (it != _mapNames.end()) {
-		string mapName = it->second;
-		_keyMap[mapName] = true;
+	auto it = _keyActions.find(keyID);
+	if (it != _keyActions.end()) {
+		_keyState.set(it->second);
+		recorder.Record({ INPUT_PRESS, keyID, 0, 0 });
 	}
 
 }
 
 void Engine::Game::ReleaseKey(unsigned int keyID) {
-	auto it = _mapNames.find(keyID);
-	if (it != _mapNames.end()) {
-		string mapName = it->second;
-		_keyMap[mapName] = false;
+	auto it = _keyActions.find(keyID);
+	if (it != _keyActions.end()) {
+		_keyState.reset(it->second);
+		recorder.Record({ INPUT_RELEASE, keyID, 0, 0 });
 	}
 }
 
 void Engine::Game::SetMouseCoords(float x, float y) {
 	_mouseCoords.x = x;
 	_mouseCoords.y = y;
+	recorder.Record({ INPUT_MOUSE, 0, (int)x, (int)y });
 }
 
-bool Engine::Game::IsKeyDown(string name) {
-	// We dont want to use the associative array approach here
-	// because we don't want to create a key if it doesnt exist.
-	// So we do it manually
-	auto it = _keyMap.find(name);
-	if (it != _keyMap.end()) {
-		// Found the key
-		return it->second;
-	}
-	else {
-		// Didn't find the key
-		return false;
-	}
-}
-
-bool Engine::Game::IsKeyUp(string name) {
-	// Check if it is pressed this frame, and wasn't pressed last frame
-	if (IsKeyDown(name) == true && WasKeyDown(name) == false) {
-		return true;
+ActionID Engine::Game::InputMapping(const string& mappingName, unsigned int keyId)
+{
+	ActionID action = GetAction(mappingName);
+	if (action == INVALID_ACTION) {
+		if (_actionNames.size() == MAX_ACTIONS) {
+			Err("Too many input actions, raise MAX_ACTIONS");
+		}
+		action = (ActionID)_actionNames.size();
+		_actionNames[mappingName] = action;
 	}
-	return false;
+	_keyActions.insert(pair<unsigned int, ActionID>(keyId, action));
+	return action;
 }
 
-bool Engine::Game::WasKeyDown(string name) {
-	// We dont want to use the associative array approach here
-	// because we don't want to create a key if it doesnt exist.
-	// So we do it manually
-	auto it = _previousKeyMap.find(name);
-	if (it != _previousKeyMap.end()) {
-		// Found the key
+ActionID Engine::Game::GetAction(const string& mappingName) const
+{
+	auto it = _actionNames.find(mappingName);
+	if (it != _actionNames.end()) {
 		return it->second;
 	}
-	else {
-		// Didn't find the key
-		return false;
-	}
-}
-
-void Engine::Game::InputMapping(string mappingName, unsigned int keyId)
-{
-	_mapNames.insert(pair<unsigned int, string>(keyId, mappingName));
+	return INVALID_ACTION;
 }
 
 //Prints out an error message and exits the game
@@ -252,14 +458,19 @@ void Engine::Game::Err(string errorString)
 	exit(1);
 }
 
+void Engine::Game::Quit()
+{
+	state = State::EXIT;
+}
+
 void Engine::Game::LimitFPS()
 {
-	//Limit the FPS to the max FPS
-	SDL_Delay((Uint32)(targetFrameTime));
+	//Limit the FPS to the max FPS, only waiting for what is left of the frame
+	framePacer.EndFrame();
 
 }
 
-void Engine::Game::CheckShaderErrors(GLuint shader, string type)
+bool Engine::Game::CheckShaderErrors(GLuint shader, string type, string& error)
 {
 	GLint success;
 	GLchar infoLog[1024];
@@ -269,7 +480,8 @@ void Engine::Game::CheckShaderErrors(GLuint shader, string type)
 		if (!success)
 		{
 			glGetShaderInfoLog(shader, 1024, NULL, infoLog);
-			Err("| ERROR::::SHADER-COMPILATION-ERROR of type: " + type + "|\n" + infoLog + "\n| -- --------------------------------------------------- -- |");
+			error = "| ERROR::::SHADER-COMPILATION-ERROR of type: " + type + "|\n" + infoLog + "\n| -- --------------------------------------------------- -- |";
+			return false;
 		}
 	}
 	else
@@ -278,98 +490,195 @@ void Engine::Game::CheckShaderErrors(GLuint shader, string type)
 		if (!success)
 		{
 			glGetProgramInfoLog(shader, 1024, NULL, infoLog);
-			Err("| ERROR::::PROGRAM-LINKING-ERROR of type: " + type + "|\n" + infoLog + "\n| -- --------------------------------------------------- -- |");
+			error = "| ERROR::::PROGRAM-LINKING-ERROR of type: " + type + "|\n" + infoLog + "\n| -- --------------------------------------------------- -- |";
+			return false;
 		}
 	}
+	return true;
 }
 
-GLuint Engine::Game::BuildShader(const char* vertexPath, const char* fragmentPath, const char* geometryPath)
+bool Engine::Game::ReadShaderSources(const ShaderSource& source, string& vertexCode, string& fragmentCode, string& geometryCode)
 {
-	// 1. Retrieve the vertex/fragment source code from filePath
-	string vertexCode;
-	string fragmentCode;
-	string geometryCode;
-	ifstream vShaderFile;
-	ifstream fShaderFile;
-	ifstream gShaderFile;
-	// ensures ifstream objects can throw exceptions:
-	vShaderFile.exceptions(ifstream::failbit | ifstream::badbit);
-	fShaderFile.exceptions(ifstream::failbit | ifstream::badbit);
-	gShaderFile.exceptions(ifstream::failbit | ifstream::badbit);
-	try
-	{
-		// Open files
-		vShaderFile.open(vertexPath);
-		fShaderFile.open(fragmentPath);
-		stringstream vShaderStream, fShaderStream;
-		// Read file's buffer contents into streams
-		vShaderStream << vShaderFile.rdbuf();
-		fShaderStream << fShaderFile.rdbuf();
-		// close file handlers
-		vShaderFile.close();
-		fShaderFile.close();
-		// Convert stream into string
-		vertexCode = vShaderStream.str();
-		fragmentCode = fShaderStream.str();
-		// If geometry shader path is present, also load a geometry shader
-		if (geometryPath != nullptr)
-		{
-			gShaderFile.open(geometryPath);
-			stringstream gShaderStream;
-			gShaderStream << gShaderFile.rdbuf();
-			gShaderFile.close();
-			geometryCode = gShaderStream.str();
-		}
+	// 1. Retrieve the vertex/fragment source code, from the archive or the loose files.
+	// While hot reloading the files being edited are the ones that count
+	bool preferLoose = shaderWatcher.IsRunning();
+	if (!assets.ReadText(source.vertexPath, vertexCode, preferLoose) || !assets.ReadText(source.fragmentPath, fragmentCode, preferLoose)) {
+		return false;
 	}
-	catch (ifstream::failure e)
-	{
-		Err("ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ");
+	// If geometry shader path is present, also load a geometry shader
+	if (!source.geometryPath.empty() && !assets.ReadText(source.geometryPath, geometryCode, preferLoose)) {
+		return false;
+	}
+	return true;
+}
+
+GLuint Engine::Game::LinkProgram(const string& vertexCode, const string& fragmentCode, const string& geometryCode, string& error)
+{
+	// Warm start, the driver takes the binary it gave us last time
+	uint64_t key = programCache.MakeKey(vertexCode, fragmentCode, geometryCode);
+	GLuint program = glCreateProgram();
+	if (programCache.Load(key, program)) {
+		return program;
 	}
+	glDeleteProgram(program);
+
 	const GLchar* vShaderCode = vertexCode.c_str();
 	const GLchar * fShaderCode = fragmentCode.c_str();
+	bool success = true;
 	// 2. Compile shaders
 	GLuint vertex, fragment;
 	// Vertex Shader
 	vertex = glCreateShader(GL_VERTEX_SHADER);
 	glShaderSource(vertex, 1, &vShaderCode, NULL);
 	glCompileShader(vertex);
-	CheckShaderErrors(vertex, "VERTEX");
+	success = CheckShaderErrors(vertex, "VERTEX", error) && success;
 	// Fragment Shader
 	fragment = glCreateShader(GL_FRAGMENT_SHADER);
 	glShaderSource(fragment, 1, &fShaderCode, NULL);
 	glCompileShader(fragment);
-	CheckShaderErrors(fragment, "FRAGMENT");
+	success = CheckShaderErrors(fragment, "FRAGMENT", error) && success;
 	// If geometry shader is given, compile geometry shader
-	GLuint geometry;
-	if (geometryPath != nullptr)
+	GLuint geometry = 0;
+	if (!geometryCode.empty())
 	{
 		const GLchar * gShaderCode = geometryCode.c_str();
 		geometry = glCreateShader(GL_GEOMETRY_SHADER);
 		glShaderSource(geometry, 1, &gShaderCode, NULL);
 		glCompileShader(geometry);
-		CheckShaderErrors(geometry, "GEOMETRY");
+		success = CheckShaderErrors(geometry, "GEOMETRY", error) && success;
 	}
 	// Shader Program
-	GLuint program = glCreateProgram();
-	glAttachShader(program, vertex);
-	glAttachShader(program, fragment);
-	if (geometryPath != nullptr)
-		glAttachShader(program, geometry);
-	glLinkProgram(program);
-	CheckShaderErrors(program, "PROGRAM");
+	program = glCreateProgram();
+	if (success) {
+		glAttachShader(program, vertex);
+		glAttachShader(program, fragment);
+		if (geometry != 0)
+			glAttachShader(program, geometry);
+		// Ask the driver to keep a binary we can store in the cache
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		glLinkProgram(program);
+		success = CheckShaderErrors(program, "PROGRAM", error);
+	}
 	// Delete the shaders as they're linked into our program now and no longer necessery
 	glDeleteShader(vertex);
 	glDeleteShader(fragment);
-	if (geometryPath != nullptr)
+	if (geometry != 0)
 		glDeleteShader(geometry);
+
+	if (!success) {
+		glDeleteProgram(program);
+		return 0;
+	}
+	programCache.Save(key, program);
 	return program;
+}
 
+Engine::Shader* Engine::Game::BuildShader(const char* vertexPath, const char* fragmentPath, const char* geometryPath)
+{
+	ShaderSource source = { vertexPath, fragmentPath, geometryPath != nullptr ? geometryPath : "" };
+	string vertexCode;
+	string fragmentCode;
+	string geometryCode;
+	if (!ReadShaderSources(source, vertexCode, fragmentCode, geometryCode)) {
+		Err("ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ");
+	}
+	string error;
+	GLuint program = LinkProgram(vertexCode, fragmentCode, geometryCode, error);
+	if (program == 0) {
+		Err(error);
+	}
+
+	// Reflect the uniforms once so rendering never looks them up by name
+	Shader* shader = new Shader();
+	shader->Attach(program);
+	shaders.push_back(unique_ptr<Shader>(shader));
+	shaderSources.push_back(source);
+
+	if (shaderWatcher.IsRunning()) {
+		EnableShaderHotReload();
+	}
+	return shader;
+
+}
+
+void Engine::Game::EnableShaderHotReload()
+{
+	vector<string> paths;
+	for (const ShaderSource& source : shaderSources) {
+		paths.push_back(source.vertexPath);
+		paths.push_back(source.fragmentPath);
+		if (!source.geometryPath.empty()) {
+			paths.push_back(source.geometryPath);
+		}
+	}
+	shaderWatcher.Start(paths);
+}
+
+void Engine::Game::ReloadShaders()
+{
+	vector<string> changed = shaderWatcher.TakeChanged();
+	if (changed.empty()) {
+		return;
+	}
+	bool reloaded = false;
+
+	for (size_t i = 0; i < shaders.size(); i++) {
+		const ShaderSource& source = shaderSources[i];
+		bool dirty = false;
+		for (const string& path : changed) {
+			dirty = dirty || path == source.vertexPath || path == source.fragmentPath || path == source.geometryPath;
+		}
+		if (!dirty) {
+			continue;
+		}
+
+		// A broken edit keeps the last good program running
+		string vertexCode, fragmentCode, geometryCode, error;
+		if (!ReadShaderSources(source, vertexCode, fragmentCode, geometryCode)) {
+			cout << "Shader reload failed, could not read " << source.vertexPath << " / " << source.fragmentPath << endl;
+			continue;
+		}
+		GLuint program = LinkProgram(vertexCode, fragmentCode, geometryCode, error);
+		if (program == 0) {
+			cout << "Shader reload failed, keeping the last good program" << endl << error << endl;
+			continue;
+		}
+		shaders[i]->Attach(program);
+		stateCache.Invalidate();
+		reloaded = true;
+		cout << "Reloaded shader " << source.vertexPath << " / " << source.fragmentPath << endl;
+	}
+	if (reloaded) {
+		OnShadersReloaded();
+	}
+}
+
+void Engine::Game::UseShader(Shader* shader)
+{
+	// Uses the current shader, skipping the call if it is already bound
+	stateCache.UseProgram(shader->GetProgram());
+}
+
+void Engine::Game::SetProjection(const mat4& projection)
+{
+	frameUniforms.projection = projection;
+}
+
+void Engine::Game::InitFrameUniforms()
+{
+	glGenBuffers(1, &frameUBO);
+	glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORM_BINDING, frameUBO);
 }
 
-void Engine::Game::UseShader(GLuint program)
+void Engine::Game::UploadFrameUniforms()
 {
-	// Uses the current shader
-	glUseProgram(program);
+	glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &frameUniforms);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	Profiler::Get().CountUpload(sizeof(FrameUniforms));
 }
 
 unsigned int Engine::Game::GetScreenHeight() {
@@ -0,0 +1,91 @@
+#include "Generator.h"
+
+#include <cstdlib>
+
+
+uint32_t Engine::BoardGenerator::Forbidden(const Board& board, int x, int y)
+{
+	int width = board.GetWidth(), height = board.GetHeight();
+	uint32_t forbidden = 0;
+	// The other two cells of every line of 3 through (x, y), empty cells never match
+	const int lines[6][4] = {
+		{ -2, 0, -1, 0 }, { -1, 0, 1, 0 }, { 1, 0, 2, 0 },
+		{ 0, -2, 0, -1 }, { 0, -1, 0, 1 }, { 0, 1, 0, 2 },
+	};
+	for (const int* line : lines) {
+		int x1 = x + line[0], y1 = y + line[1], x2 = x + line[2], y2 = y + line[3];
+		if (x1 < 0 || x2 < 0 || x1 >= width || x2 >= width || y1 < 0 || y2 < 0 || y1 >= height || y2 >= height) {
+			continue;
+		}
+		uint8_t colour = board.Get(x1, y1);
+		if (colour != BOARD_EMPTY && board.Get(x2, y2) == colour) {
+			forbidden |= 1u << colour;
+		}
+	}
+	return forbidden;
+}
+
+bool Engine::BoardGenerator::Fill(Board& board, Random& random)
+{
+	int width = board.GetWidth(), height = board.GetHeight(), colours = board.GetColourCount();
+	board.Clear();
+
+	// Plant c c _ c along a row or a column, swapping the last piece into the gap is legal
+	bool vertical = width < 4 || (height >= 4 && random.NextInt(2) != 0);
+	int x = (int)random.NextInt(vertical ? width : width - 3);
+	int y = (int)random.NextInt(vertical ? height - 3 : height);
+	uint8_t planted = (uint8_t)random.NextInt(colours);
+	int dx = vertical ? 0 : 1, dy = vertical ? 1 : 0;
+	const int plant[3][2] = { { x, y }, { x + dx, y + dy }, { x + 3 * dx, y + 3 * dy } };
+	for (const int* cell : plant) {
+		board.Set(cell[0], cell[1], planted);
+	}
+
+	uint32_t all = (1u << colours) - 1;
+	for (int cy = 0; cy < height; cy++) {
+		for (int cx = 0; cx < width; cx++) {
+			if (board.Get(cx, cy) != BOARD_EMPTY) {
+				continue;
+			}
+			// Filling in row order, only the two cells to the left and above are set,
+			// apart from the planted ones which need every line checked
+			uint32_t forbidden = 0;
+			if (cx >= 2 && board.Get(cx - 1, cy) == board.Get(cx - 2, cy)) {
+				forbidden |= 1u << board.Get(cx - 1, cy);
+			}
+			if (cy >= 2 && board.Get(cx, cy - 1) == board.Get(cx, cy - 2)) {
+				forbidden |= 1u << board.Get(cx, cy - 1);
+			}
+			for (const int* cell : plant) {
+				if ((cy == cell[1] && abs(cx - cell[0]) <= 2) || (cx == cell[0] && abs(cy - cell[1]) <= 2)) {
+					forbidden |= Forbidden(board, cx, cy);
+					break;
+				}
+			}
+			uint32_t allowed = all & ~forbidden;
+			if (allowed == 0) {
+				return false;
+			}
+			// n-th allowed colour
+			for (unsigned int pick = random.NextInt(PopCount(allowed)); pick; pick--) {
+				allowed &= allowed - 1;
+			}
+			board.Set(cx, cy, (uint8_t)LowestBit(allowed));
+		}
+	}
+	return true;
+}
+
+bool Engine::BoardGenerator::Generate(Board& board, Random& random)
+{
+	if (board.GetColourCount() < 2 || (board.GetWidth() < 4 && board.GetHeight() < 4)) {
+		return false;
+	}
+	for (int attempt = 0; attempt < GENERATOR_MAX_ATTEMPTS; attempt++) {
+		if (Fill(board, random)) {
+			return true;
+		}
+	}
+	board.Clear();
+	return false;
+}
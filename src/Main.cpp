@@ -0,0 +1,20 @@
+#include "Menu.h"
+
+
+int main(int argc, char** argv) {
+
+	Menu menu;
+	// --record <file> logs the session, --replay <file> plays one back
+	for (int i = 1; i + 1 < argc; i++) {
+		string option = argv[i];
+		if (option == "--record" && !menu.StartRecording(argv[i + 1], SDL_GetPerformanceCounter())) {
+			cout << "Unable to record to " << argv[i + 1] << endl;
+		}
+		if (option == "--replay" && !menu.StartReplay(argv[i + 1])) {
+			cout << "Unable to replay " << argv[i + 1] << endl;
+		}
+	}
+	menu.Start("User Interface Menu", 800, 600, false, WindowFlag::WINDOWED, 60, 1);
+
+	return 0;
+}
@@ -8,30 +8,54 @@ Menu::Menu()
 
 Menu::~Menu()
 {
-	if (Mix_Playing(sfx_channel) == 0) {
-		//Mix_FreeChunk(moveSound);
-		//Mix_FreeChunk(gameClickSound);
-		//Mix_FreeChunk(menuClickSound);
-		//Mix_FreeChunk(matchSound);
-		//Mix_FreeChunk(switchSound);
-		//Mix_FreeChunk(sound);
-	}
-	if (music != NULL) {
-		Mix_FreeMusic(music);
-	}
-	Mix_CloseAudio();
+	audio.DeInit();
 }
 
 
 void Menu::Init()
 {
-	InitText();
-	InitButton();
-	this->program = BuildShader("shader.vert", "shader.frag");
-	InputMapping("SelectButton", SDLK_RETURN);
-	InputMapping("NextButton", SDLK_DOWN);
-	InputMapping("PrevButton", SDLK_UP);
+	// Start decoding on the workers first, the shaders compile meanwhile
 	InitAudio();
+	InitButton();
+	InitText();
+	this->shader = BuildShader("shader.vert", "shader.frag");
+	this->spriteShader = BuildShader("sprite.vert", "sprite.frag");
+	textUniform = shader->GetUniform("text");
+	glowColorUniform = shader->GetUniform("glowColor");
+	glowWidthUniform = shader->GetUniform("glowWidth");
+	textureUniform = shader->GetUniform("ourTexture");
+	modelUniform = shader->GetUniform("model");
+	spriteTextureUniform = spriteShader->GetUniform("ourTexture");
+	SetupShaders();
+#ifdef _DEBUG
+	EnableShaderHotReload();
+#endif
+
+	// Set orthographic projection, shared by every shader through the frame uniform block
+	SetProjection(ortho(0.0f, static_cast<GLfloat>(GetScreenWidth()), static_cast<GLfloat>(GetScreenHeight()), 0.0f, -1.0f, 1.0f));
+	selectAction = InputMapping("SelectButton", SDLK_RETURN);
+	nextAction = InputMapping("NextButton", SDLK_DOWN);
+	prevAction = InputMapping("PrevButton", SDLK_UP);
+	profileAction = InputMapping("DumpProfile", SDLK_F9);
+	musicAction = InputMapping("ToggleMusic", SDLK_m);
+}
+
+void Menu::SetupShaders()
+{
+	UseShader(this->shader);
+	// The font is a distance field, one atlas for every text size
+	shader->SetInt(textUniform, 2);
+	shader->SetVec4(glowColorUniform, vec4(1.0f, 0.2f, 0.2f, 0.4f));
+	shader->SetFloat(glowWidthUniform, 0.2f);
+	shader->SetInt(textureUniform, 0);
+	shader->SetMat4(modelUniform, mat4());
+	UseShader(this->spriteShader);
+	spriteShader->SetInt(spriteTextureUniform, 0);
+}
+
+void Menu::OnShadersReloaded()
+{
+	SetupShaders();
 }
 
 void Menu::DeInit() {
@@ -40,74 +64,119 @@ void Menu::DeInit() {
 
 void Menu::Update(float deltaTime)
 {
-	if (Mix_Playing(sfx_channel) == 0 && IsKeyDown("SFX")) {
-		//sfx_channel = Mix_PlayChannel(-1, sound, 0);
-		if (sfx_channel == -1) {
-			Err("Unable to play WAV file: " + string(Mix_GetError()));
-		}
+	PollAssets();
+	tweens.Update(deltaTime);
+
+	// Music starts once it is loaded and is only touched on transitions
+	if (musicState == MusicState::STOPPED && audio.HasMusic()) {
+		SetMusicState(MusicState::PLAYING);
 	}
-	if (Mix_PlayingMusic() == 0)
-	{
-		//Play the music
-		Mix_PlayMusic(music, -1);
-		SDL_Delay(150);
+	if (IsKeyUp(musicAction)) {
+		SetMusicState(musicState == MusicState::PLAYING ? MusicState::PAUSED : MusicState::PLAYING);
 	}
-	//If music is being played
-	else
-	{
-		//If the music is paused
-		if (Mix_PausedMusic() == 1)
-		{
-			//Resume the music
-			Mix_ResumeMusic();
-			SDL_Delay(150);
-		}
-		//If the music is playing
-		else
-		{
-			//Pause the music
-			Mix_PauseMusic();
-			SDL_Delay(150);
+
+	if (IsKeyUp(profileAction)) {
+		Engine::Profiler::Get().PrintSummary();
+		if (Engine::Profiler::Get().ExportChromeTrace("profile.json")) {
+			cout << "Profile written to profile.json" << endl;
 		}
 	}
-	if (IsKeyDown("SelectButton")) {
-		if (activeButtonIndex == 0) {
-			Mix_PlayMusic(menuClickSound, 0);
-			
-			//play();
-		}
-		else if (activeButtonIndex == 1) {
-			Mix_PlayMusic(menuClickSound, 0);
+
+	// Timers run every frame so a held key repeats at the same pace whatever the frame rate
+	bool next = nextRepeat.Update(IsKeyDown(nextAction), deltaTime);
+	bool prev = prevRepeat.Update(IsKeyDown(prevAction), deltaTime);
+	bool select = selectRepeat.Update(IsKeyDown(selectAction), deltaTime);
+
+	switch (menuState) {
+	case MenuState::BROWSING:
+		if (next) {
+			HandleEvent(MenuEvent::NEXT);
 		}
-		else if (activeButtonIndex == 2) {
-			Mix_PlayMusic(menuClickSound, 0);
+		if (prev) {
+			HandleEvent(MenuEvent::PREV);
 		}
-		else if (activeButtonIndex == 3) {
-			Mix_PlayMusic(menuClickSound, 0);
+		if (select) {
+			HandleEvent(MenuEvent::SELECT);
 		}
-		else if (activeButtonIndex == 4) {
-			Mix_PlayMusic(menuClickSound, 0);
-			SDL_Quit();
-			exit(0);
+		break;
+	case MenuState::EXITING:
+		exitTimer -= deltaTime;
+		if (exitTimer <= 0) {
+			Quit();
 		}
+		break;
 	}
 
-	if (IsKeyUp("NextButton")) {
+}
+
+void Menu::HandleEvent(MenuEvent event)
+{
+	switch (event) {
+	case MenuEvent::NEXT:
 		if (activeButtonIndex < NUM_BUTTON - 1) {
-			Mix_PlayMusic(moveSound, 0);
-			activeButtonIndex = activeButtonIndex + 1;
-			SDL_Delay(150);
+			audio.Play(moveSound, SFX_PRIORITY_MOVE);
+			SetActiveButton(activeButtonIndex + 1);
 		}
-	}
-
-	if (IsKeyUp("PrevButton")) {
+		break;
+	case MenuEvent::PREV:
 		if (activeButtonIndex > 0) {
-			Mix_PlayMusic(moveSound, 0);
-			activeButtonIndex = activeButtonIndex - 1;
-			SDL_Delay(150);
+			audio.Play(moveSound, SFX_PRIORITY_MOVE);
+			SetActiveButton(activeButtonIndex - 1);
 		}
+		break;
+	case MenuEvent::SELECT:
+		audio.Play(menuClickSound, SFX_PRIORITY_CLICK);
+		if (activeButtonIndex == 0) {
+			//play();
+		}
+		else if (activeButtonIndex == 4) {
+			// Let the click be heard, without blocking the loop
+			menuState = MenuState::EXITING;
+			exitTimer = EXIT_DELAY;
+			SetMusicState(MusicState::STOPPED);
+		}
+		break;
 	}
+}
 
+void Menu::SetActiveButton(int index)
+{
+	// Restarting from the current value, so quick presses never jump
+	tweens.Cancel(&buttonHover[activeButtonIndex]);
+	tweens.Cancel(&buttonHover[index]);
+	tweens.Add(&buttonHover[activeButtonIndex], 0.0f, BUTTON_FADE_TIME, Engine::Easing::QUAD_OUT);
+	tweens.Add(&buttonHover[index], 1.0f, BUTTON_FADE_TIME, Engine::Easing::QUAD_OUT);
+	activeButtonIndex = index;
+}
+
+void Menu::SetMusicState(MusicState next)
+{
+	if (next == musicState) {
+		return;
+	}
+	switch (next) {
+	case MusicState::PLAYING:
+		if (!audio.HasMusic()) {
+			return;
+		}
+		if (musicState == MusicState::PAUSED) {
+			audio.ResumeMusic();
+		}
+		else {
+			audio.PlayMusic(-1);
+		}
+		break;
+	case MusicState::PAUSED:
+		if (musicState != MusicState::PLAYING) {
+			return;
+		}
+		audio.PauseMusic();
+		break;
+	case MusicState::STOPPED:
+		audio.StopMusic();
+		break;
+	}
+	musicState = next;
 }
 
 void Menu::Render()
@@ -115,284 +184,162 @@ void Menu::Render()
 	//Setting Viewport
 	glViewport(0, 0, GetScreenWidth(), GetScreenHeight());
 
-	//Clear the color and depth buffer
+	//Set the background color, then clear the color and depth buffer
+	GetStateCache().SetClearColor(vec4(0.0f, 0.0f, 0.0f, 1.0f));
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	//Set the background color
-	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-
-	// Set orthographic projection
-	mat4 projection;
-	projection = ortho(0.0f, static_cast<GLfloat>(GetScreenWidth()), static_cast<GLfloat>(GetScreenHeight()), 0.0f, -1.0f, 1.0f);
-	glUniformMatrix4fv(glGetUniformLocation(this->program, "projection"), 1, GL_FALSE, value_ptr(projection));
-
-
-	RenderText("Virus Hazard", GetScreenWidth()/2-150, 10, 1.0f, vec3(1, 0, 0));
-	//RenderText("Virus Hazard", 10, 10, 1.0f, vec3(244.0f / 255.0f, 12.0f / 255.0f, 116.0f / 255.0f));
+	// Only records draws, the render queue groups them by material after Render() returns
+	if (fontReady) {
+		// Laid out once, only the draw is recorded each frame
+		title.Submit(GetRenderQueue(), Engine::RENDER_PASS_UI, 0, this->shader);
+		// Strings that change every frame go through the batch
+		textBatch.Begin(&font);
+		//RenderText("Virus Hazard", 10, 10, 1.0f, vec3(244.0f / 255.0f, 12.0f / 255.0f, 116.0f / 255.0f));
+		textBatch.Submit(GetRenderQueue(), Engine::RENDER_PASS_UI, 0, this->shader);
+	}
 
+	spriteBatch.Begin();
 	RenderButton();
+	spriteBatch.Submit(GetRenderQueue(), Engine::RENDER_PASS_UI, this->spriteShader);
 
 }
 
 void Menu::InitText() {
-	// Init Freetype
-	FT_Library ft;
-	if (FT_Init_FreeType(&ft)) {
-		Err("ERROR::FREETYPE: Could not init FreeType Library");
-	}
-	FT_Face face;
-	if (FT_New_Face(ft, FONTNAME, 0, &face)) {
-		Err("ERROR::FREETYPE: Failed to load font");
-	}
-
-	FT_Set_Pixel_Sizes(face, 0, FONTSIZE);
-
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Disable byte-alignment restriction
-	for (GLubyte c = 0; c < 128; c++)
-	{
-		// Load character glyph
-		if (FT_Load_Char(face, c, FT_LOAD_RENDER))
-		{
-			std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
-			continue;
-		}
-		// Generate texture
-		GLuint texture;
-		glGenTextures(1, &texture);
-		glBindTexture(GL_TEXTURE_2D, texture);
-		glTexImage2D(
-			GL_TEXTURE_2D,
-			0,
-			GL_RED,
-			face->glyph->bitmap.width,
-			face->glyph->bitmap.rows,
-			0,
-			GL_RED,
-			GL_UNSIGNED_BYTE,
-			face->glyph->bitmap.buffer
-		);
-		// Set texture options
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		// Now store character for later use
-		Character character = {
-			texture,
-			ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-			ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-			face->glyph->advance.x
-		};
-		Characters.insert(pair<GLchar, Character>(c, character));
-	}
-
-	FT_Done_Face(face);
-	FT_Done_FreeType(ft);
-
-	glGenVertexArrays(1, &VAO);
-	glGenBuffers(1, &VBO);
-	glBindVertexArray(VAO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 4 * 4, NULL,
-		GL_DYNAMIC_DRAW);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), 0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	// Rasterised on a worker, uploaded by PollAssets
+	fontBitmap = GetAssets().LoadSDFFont(FONTNAME);
+	textBatch.Init();
+	title.Init();
+	title.SetText("Virus Hazard");
+	title.SetColor(vec4(1, 0, 0, 1));
+	title.SetAlign(Engine::TextAlign::CENTER);
+	title.SetPosition(vec2(GetScreenWidth() / 2.0f, 10));
 }
 
-void Menu::RenderText(string text, GLfloat x, GLfloat y, GLfloat scale, vec3 color)
+void Menu::RenderText(const string& text, GLfloat x, GLfloat y, GLfloat scale, vec3 color)
 {
-	// Activate corresponding render state
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	UseShader(this->program);
-
-	glUniform3f(glGetUniformLocation(this->program, "ourColor"), color.x, color.y, color.z);
-	glUniform1i(glGetUniformLocation(this->program, "text"), 1);
-	glActiveTexture(GL_TEXTURE0);
-	glUniform1i(glGetUniformLocation(this->program, "ourTexture"), 0);
-	mat4 model;
-	glUniformMatrix4fv(glGetUniformLocation(this->program, "model"), 1, GL_FALSE, value_ptr(model));
-	glBindVertexArray(VAO);
-
-	// Iterate through all characters
-	string::const_iterator c;
-	for (c = text.begin(); c != text.end(); c++)
-	{
-		Character ch = Characters[*c];
-		GLfloat xpos = x + ch.Bearing.x * scale;
-		GLfloat ypos = y + (this->Characters['H'].Bearing.y - ch.Bearing.y) * scale;
-		GLfloat w = ch.Size.x * scale;
-		GLfloat h = ch.Size.y * scale;
-		// Update VBO for each character
-
-		GLfloat vertices[] = {
-			// Positions   // Texture Coords
-			xpos + w,	ypos + h,	1.0f, 1.0f, // Bottom Right
-			xpos + w,	ypos,		1.0f, 0.0f, // Top Right
-			xpos,		ypos,		0.0f, 0.0f, // Top Left
-			xpos,		ypos + h,	0.0f, 1.0f  // Bottom Left 
-		};
-		// Render glyph texture over quad
-		glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-		// Update content of VBO memory
-		glBindBuffer(GL_ARRAY_BUFFER, VBO);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		// Render quad
-		glDrawArrays(GL_QUADS, 0, 4);
-		// Now advance cursors for next glyph (note that advance is number of 1 / 64 pixels)
-		x += (ch.Advance >> 6) * scale; // Bitshift by 6 to get value in pixels(2 ^ 6 = 64)
-	}
-	glBindVertexArray(0);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	glDisable(GL_BLEND);
+	// Only queues the glyphs, they are drawn together by the render queue
+	// Scale 1 stays FONTSIZE pixels, whatever size the atlas was generated at
+	textBatch.AddText(text, x, y, scale * FONTSIZE / font.GetPixelSize(), vec4(color, 1.0f));
 }
 
 void Menu::InitButton() {
 	string buttons[NUM_BUTTON] = { "button_play.png", "button_highscore.png", "button_options.png", "button_credits.png", "button_exit.png" };
 	string hover_buttons[NUM_BUTTON] = { "button_play_hover.png", "button_highscore_hover.png",  "button_options_hover.png", "button_credits_hover.png", "button_exit_hover.png" };
 
-	glGenTextures(5, &texture[0]);
-	glGenTextures(5, &hover_texture[0]);
+	// Every button and hover state lives in one atlas so they can be drawn together
+	glGenTextures(1, &buttonAtlas);
+	glBindTexture(GL_TEXTURE_2D, buttonAtlas); // All upcoming GL_TEXTURE_2D operations now have effect on our texture object
+
+	// Set texture filtering
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, BUTTON_ATLAS_SIZE, BUTTON_ATLAS_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	glBindTexture(GL_TEXTURE_2D, 0); // Unbind texture when done, so we won't accidentily mess up our texture.
 
+	// Decoded on the workers, packed into the atlas by PollAssets as they arrive
 	for (int i = 0; i < NUM_BUTTON; i++) {
-		// Load and create a texture 
-		glBindTexture(GL_TEXTURE_2D, texture[i]); // All upcoming GL_TEXTURE_2D operations now have effect on our texture object
-
-		// Set texture filtering
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		// Load, create texture 
-		int width, height;
-		unsigned char* image = SOIL_load_image(buttons[i].c_str(), &width, &height, 0, SOIL_LOAD_RGBA);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-		SOIL_free_image_data(image);
-		glBindTexture(GL_TEXTURE_2D, 0); // Unbind texture when done, so we won't accidentily mess up our texture.
-
-		// Set up vertex data (and buffer(s)) and attribute pointers
-		button_width[i] = (float)width;
-		button_height[i] = (float)height;
-
-		// Load and create a texture 
-		glBindTexture(GL_TEXTURE_2D, hover_texture[i]); // All upcoming GL_TEXTURE_2D operations now have effect on our texture object
-
-		// Set texture filtering
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		image = SOIL_load_image(hover_buttons[i].c_str(), &width, &height, 0, SOIL_LOAD_RGBA);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-		SOIL_free_image_data(image);
-		glBindTexture(GL_TEXTURE_2D, 0); // Unbind texture when done, so we won't accidentily mess up our texture.
-
-		 // Set up vertex data (and buffer(s)) and attribute pointers
-		hover_button_width[i] = (float)width;
-		hover_button_height[i] = (float)height;
+		buttonImages[i] = GetAssets().LoadImage(buttons[i]);
+		buttonImages[NUM_BUTTON + i] = GetAssets().LoadImage(hover_buttons[i]);
 	}
 
-	GLfloat vertices[] = {
-		// Positions	// Texture Coords
-		1,  1,			1.0f, 1.0f, // Bottom Right
-		1,  0,			1.0f, 0.0f, // Top Right
-		0,  0,			0.0f, 0.0f, // Top Left
-		0,  1,			0.0f, 1.0f  // Bottom Left 
-	};
-
-
-	glGenVertexArrays(1, &VAO2);
-	glGenBuffers(1, &VBO2);
-	glBindVertexArray(VAO2);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO2);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), 0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	spriteBatch.Init();
 }
 
 void Menu::RenderButton() {
-	// Enable transparency
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	// Bind Textures using texture units
-	int texture_id[NUM_BUTTON] = { GL_TEXTURE1, GL_TEXTURE2, GL_TEXTURE3, GL_TEXTURE4, GL_TEXTURE5 };
-	// Activate shader
-	UseShader(this->program);
-	glUniform1i(glGetUniformLocation(this->program, "text"), 0);
-
-	glBindVertexArray(VAO2);
+	// Only queues the buttons, they are drawn together by the render queue
 	for (int i = 0; i < NUM_BUTTON; i++) {
-
-		glActiveTexture(texture_id[i]);
-		glBindTexture(GL_TEXTURE_2D, (activeButtonIndex == i) ? hover_texture[i] : texture[i]);
-		glUniform1i(glGetUniformLocation(this->program, "ourTexture"), i + 1);
-
-		mat4 model;
-		model = translate(model, vec3((GetScreenWidth() - button_width[i]) / 2, (i + 1) * 100, 0.0f));
-		model = scale(model, vec3(button_width[i], button_height[i], 1));
-		glUniformMatrix4fv(glGetUniformLocation(this->program, "model"), 1, GL_FALSE, value_ptr(model));
-
-		glDrawArrays(GL_QUADS, 0, 4);
+		// The hover state fades in over the normal button, either may still be loading
+		float hover = buttonHover[i];
+		if (hover < 1 && Engine::IsReady(buttonUploads[i])) {
+			vec2 position = vec2((GetScreenWidth() - button_width[i]) / 2, (i + 1) * 100.0f);
+			spriteBatch.Draw(buttonAtlas, position, vec2(button_width[i], button_height[i]), button_uv[i]);
+		}
+		if (hover > 0 && Engine::IsReady(buttonUploads[NUM_BUTTON + i])) {
+			vec2 position = vec2((GetScreenWidth() - hover_button_width[i]) / 2, (i + 1) * 100.0f);
+			spriteBatch.Draw(buttonAtlas, position, vec2(hover_button_width[i], hover_button_height[i]), hover_button_uv[i], vec4(1, 1, 1, hover));
+		}
 	}
-
-	glBindVertexArray(0);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	glDisable(GL_BLEND);
 }
 
 void Menu::InitAudio() {
-	int flags = MIX_INIT_MP3 | MIX_INIT_FLAC | MIX_INIT_OGG;
-	if (flags != Mix_Init(flags)) {
-		Err("Unable to initialize mixer: " + string(Mix_GetError()));
+	string error;
+	if (!audio.Init(AUDIO_DEFAULT_RATE, AUDIO_DEFAULT_BUFFER, AUDIO_DEFAULT_VOICES, error)) {
+		Err(error);
 	}
 
-	int audio_rate = 22050; Uint16 audio_format = AUDIO_S16SYS; int audio_channels = 2; int audio_buffers = 4096;
-
-	if (Mix_OpenAudio(audio_rate, audio_format, audio_channels, audio_buffers) != 0) {
-		Err("Unable to initialize audio: " + string(Mix_GetError()));
+	// Effects are decoded to PCM up front so playing one never touches the disk
+	string sounds[NUM_SOUND] = { "click1.ogg", "rollover1.ogg", "switch2.ogg", "switch3.ogg", "click2.ogg" };
+	for (int i = 0; i < NUM_SOUND; i++) {
+		soundLoads[i] = GetAssets().LoadSound(sounds[i]);
 	}
+	musicLoad = GetAssets().LoadMusic(MUSICNAME);
+}
 
+void Menu::PollAssets() {
+	Engine::AssetManager& assets = GetAssets();
 
-	menuClickSound = Mix_LoadMUS("click1.ogg");
-	if (menuClickSound == NULL) {
-		Err("Unable to load sound file: " + string(Mix_GetError()));
-	}
-	matchSound = Mix_LoadMUS("rollover1.ogg");
-	if (matchSound== NULL) {
-		Err("Unable to load WAV file: " + string(Mix_GetError()));
+	for (int i = 0; i < NUM_BUTTON * 2; i++) {
+		if (buttonUploads[i].valid() || !Engine::IsReady(buttonImages[i])) {
+			continue;
+		}
+		shared_ptr<Engine::Image> image = buttonImages[i].get();
+		if (image == nullptr) {
+			Err("Unable to load button image " + to_string(i));
+		}
+		ivec2 position;
+		if (!buttonPacker.Pack(image->width, image->height, position)) {
+			Err("Button atlas is full");
+		}
+		buttonUploads[i] = assets.UploadTexture(image, buttonAtlas, position);
+
+		int index = i % NUM_BUTTON;
+		vec4 uv = vec4(position.x, position.y, position.x + image->width, position.y + image->height) * (1.0f / BUTTON_ATLAS_SIZE);
+		if (i >= NUM_BUTTON) {
+			hover_button_width[index] = (float)image->width;
+			hover_button_height[index] = (float)image->height;
+			hover_button_uv[index] = uv;
+		}
+		else {
+			button_width[index] = (float)image->width;
+			button_height[index] = (float)image->height;
+			button_uv[index] = uv;
+		}
 	}
-	switchSound = Mix_LoadMUS("switch2.ogg");
-	if (switchSound == NULL) {
-		Err("Unable to load WAV file: " + string(Mix_GetError()));
+
+	if (!fontReady && Engine::IsReady(fontBitmap)) {
+		shared_ptr<Engine::FontBitmap> bitmap = fontBitmap.get();
+		if (bitmap == nullptr) {
+			Err("ERROR::FREETYPE: Failed to load font");
+		}
+		font.Upload(*bitmap);
+		title.SetFont(&font);
+		title.SetScale((float)FONTSIZE / font.GetPixelSize());
+		fontReady = true;
 	}
-	moveSound = Mix_LoadMUS("switch3.ogg");
-	if (moveSound == NULL) {
-		Err("Unable to load WAV file: " + string(Mix_GetError()));
+
+	SoundID* sounds[NUM_SOUND] = { &menuClickSound, &matchSound, &switchSound, &moveSound, &gameClickSound };
+	for (int i = 0; i < NUM_SOUND; i++) {
+		if (*sounds[i] == INVALID_SOUND && Engine::IsReady(soundLoads[i])) {
+			const Engine::AudioAsset<Mix_Chunk>& sound = soundLoads[i].get();
+			if (sound.asset == NULL) {
+				Err("Unable to load sound file: " + sound.error);
+			}
+			*sounds[i] = audio.AddSound(sound.asset);
+		}
 	}
-	gameClickSound = Mix_LoadMUS("click2.ogg");
-	if (gameClickSound == NULL) {
-		Err("Unable to load WAV file: " + string(Mix_GetError()));
+
+	if (musicLoad.valid() && Engine::IsReady(musicLoad)) {
+		// Missing music is fine, the menu simply stays quiet
+		Mix_Music* music = musicLoad.get().asset;
+		if (music != NULL) {
+			audio.SetMusic(music);
+		}
+		musicLoad = shared_future<Engine::AudioAsset<Mix_Music>>();
 	}
-	
-	
 }
 
-int main(int argc, char** argv) {
-
-	Engine::Game &game = Menu();
-	game.Start("User Interface Menu", 800, 600, false, WindowFlag::WINDOWED, 60, 1);
-
-	return 0;
-}
 void play() {
 	//Clear the color and depth buffer
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -0,0 +1,127 @@
+#include "Moves.h"
+
+
+void Engine::MoveGenerator::ScanRow(const Board& board, int y, uint64_t& horizontal, uint64_t& vertical)
+{
+	int height = board.GetHeight();
+	uint64_t mask = board.GetRowMask();
+	horizontal = 0;
+	vertical = 0;
+	for (int c = 0; c < board.GetColourCount(); c++) {
+		// Rows around y, zero outside the board
+		uint64_t up2 = y >= 2 ? board.GetRow(y - 2, c) : 0;
+		uint64_t up1 = y >= 1 ? board.GetRow(y - 1, c) : 0;
+		uint64_t row = board.GetRow(y, c);
+		uint64_t down1 = y + 1 < height ? board.GetRow(y + 1, c) : 0;
+		uint64_t down2 = y + 2 < height ? board.GetRow(y + 2, c) : 0;
+		uint64_t down3 = y + 3 < height ? board.GetRow(y + 3, c) : 0;
+
+		// Cells of row y that complete a run of this colour when it lands there.
+		// Left, right and split pairs in the row, above, below and split pairs in the column.
+		uint64_t left = (row << 1) & (row << 2) & mask;
+		uint64_t right = (row >> 1) & (row >> 2);
+		uint64_t split = (row << 1) & (row >> 1) & mask;
+		uint64_t above = up1 & up2;
+		uint64_t below = down1 & down2;
+		uint64_t splitVertical = up1 & down1;
+		// A piece already of this colour would not change anything
+		uint64_t open = ~row & mask;
+
+		// Moving right from x - 1 leaves the left side, so left and split pairs do not count
+		uint64_t fromLeft = (row << 1) & open & (right | above | below | splitVertical);
+		uint64_t fromRight = (row >> 1) & open & (left | above | below | splitVertical);
+		horizontal |= (fromLeft >> 1) | fromRight;
+
+		// Moving up from y + 1 into row y leaves the column below
+		uint64_t fromBelow = down1 & open & (left | right | split | above);
+		vertical |= fromBelow;
+
+		// Moving down from y into row y + 1, same patterns one row lower
+		if (y + 1 < height) {
+			uint64_t openBelow = ~down1 & mask;
+			uint64_t leftBelow = (down1 << 1) & (down1 << 2) & mask;
+			uint64_t rightBelow = (down1 >> 1) & (down1 >> 2);
+			uint64_t splitBelow = (down1 << 1) & (down1 >> 1) & mask;
+			uint64_t fromAbove = row & openBelow & (leftBelow | rightBelow | splitBelow | (down2 & down3));
+			vertical |= fromAbove;
+		}
+	}
+}
+
+bool Engine::MoveGenerator::Generate(const Board& board, MoveMask& moves)
+{
+	uint64_t any = 0;
+	for (int y = 0; y < board.GetHeight(); y++) {
+		ScanRow(board, y, moves.horizontal[y], moves.vertical[y]);
+		any |= moves.horizontal[y] | moves.vertical[y];
+	}
+	return any != 0;
+}
+
+void Engine::MoveGenerator::List(const Board& board, vector<Move>& moves)
+{
+	moves.clear();
+	for (int y = 0; y < board.GetHeight(); y++) {
+		uint64_t horizontal, vertical;
+		ScanRow(board, y, horizontal, vertical);
+		for (; horizontal; horizontal &= horizontal - 1) {
+			moves.push_back({ (uint8_t)LowestBit(horizontal), (uint8_t)y, false });
+		}
+		for (; vertical; vertical &= vertical - 1) {
+			moves.push_back({ (uint8_t)LowestBit(vertical), (uint8_t)y, true });
+		}
+	}
+}
+
+unsigned int Engine::MoveGenerator::Count(const Board& board)
+{
+	unsigned int count = 0;
+	for (int y = 0; y < board.GetHeight(); y++) {
+		uint64_t horizontal, vertical;
+		ScanRow(board, y, horizontal, vertical);
+		count += PopCount(horizontal) + PopCount(vertical);
+	}
+	return count;
+}
+
+bool Engine::MoveGenerator::HasMove(const Board& board)
+{
+	for (int y = 0; y < board.GetHeight(); y++) {
+		uint64_t horizontal, vertical;
+		ScanRow(board, y, horizontal, vertical);
+		if (horizontal | vertical) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool Engine::MoveGenerator::Hint(const Board& board, Random& random, Move& move)
+{
+	MoveMask moves;
+	if (!Generate(board, moves)) {
+		return false;
+	}
+	// Pick the n-th set bit over both masks
+	unsigned int count = 0;
+	for (int y = 0; y < board.GetHeight(); y++) {
+		count += PopCount(moves.horizontal[y]) + PopCount(moves.vertical[y]);
+	}
+	unsigned int pick = random.NextInt(count);
+	for (int y = 0; y < board.GetHeight(); y++) {
+		for (int vertical = 0; vertical < 2; vertical++) {
+			uint64_t row = vertical ? moves.vertical[y] : moves.horizontal[y];
+			unsigned int inRow = PopCount(row);
+			if (pick >= inRow) {
+				pick -= inRow;
+				continue;
+			}
+			for (; pick; pick--) {
+				row &= row - 1;
+			}
+			move = { (uint8_t)LowestBit(row), (uint8_t)y, vertical != 0 };
+			return true;
+		}
+	}
+	return false;
+}
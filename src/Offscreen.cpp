@@ -0,0 +1,183 @@
+#include "Offscreen.h"
+
+#include <fstream>
+
+
+Engine::OffscreenContext::~OffscreenContext()
+{
+	Destroy();
+}
+
+#ifdef OFFSCREEN_OSMESA
+bool Engine::OffscreenContext::CreateContext(string& error)
+{
+	const int attributes[] = {
+		OSMESA_FORMAT, OSMESA_RGBA,
+		OSMESA_DEPTH_BITS, 24,
+		OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+		OSMESA_CONTEXT_MAJOR_VERSION, OFFSCREEN_GL_MAJOR,
+		OSMESA_CONTEXT_MINOR_VERSION, OFFSCREEN_GL_MINOR,
+		0
+	};
+	context = OSMesaCreateContextAttribs(attributes, NULL);
+	if (context == nullptr) {
+		error = "Failed to create OSMesa context!";
+		return false;
+	}
+	buffer.resize((size_t)width * height * 4);
+	if (!OSMesaMakeCurrent(context, buffer.data(), GL_UNSIGNED_BYTE, width, height)) {
+		error = "Failed to make OSMesa context current!";
+		return false;
+	}
+	return true;
+}
+#else
+bool Engine::OffscreenContext::CreateContext(string& error)
+{
+	// Surfaceless needs no GPU, no DRM device and no display server
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay != nullptr) {
+		display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+	}
+	if (display == EGL_NO_DISPLAY) {
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	}
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL)) {
+		error = "Failed to initialize EGL!";
+		return false;
+	}
+	if (!eglBindAPI(EGL_OPENGL_API)) {
+		error = "EGL has no desktop OpenGL!";
+		return false;
+	}
+
+	const EGLint configAttributes[] = {
+		// The default asks for window surfaces, which surfaceless displays have none of
+		EGL_SURFACE_TYPE, EGL_DONT_CARE,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+		EGL_NONE
+	};
+	EGLConfig config;
+	EGLint configCount = 0;
+	if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0) {
+		error = "No EGL config for OpenGL!";
+		return false;
+	}
+
+	const EGLint contextAttributes[] = {
+		EGL_CONTEXT_MAJOR_VERSION, OFFSCREEN_GL_MAJOR,
+		EGL_CONTEXT_MINOR_VERSION, OFFSCREEN_GL_MINOR,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE
+	};
+	context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+	if (context == EGL_NO_CONTEXT) {
+		error = "Failed to create EGL context!";
+		return false;
+	}
+	if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+		error = "Failed to make EGL context current, surfaceless contexts unsupported?";
+		return false;
+	}
+	return true;
+}
+#endif
+
+bool Engine::OffscreenContext::Create(unsigned int width, unsigned int height, string& error)
+{
+	this->width = width;
+	this->height = height;
+	if (!CreateContext(error)) {
+		Destroy();
+		return false;
+	}
+
+	// Core profile entry points are only loaded with experimental on
+	glewExperimental = GL_TRUE;
+	GLenum glewStat = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+	// GLEW built for GLX loads the GL functions first and only then misses the X display
+	if (glewStat == GLEW_ERROR_NO_GLX_DISPLAY) {
+		glewStat = GLEW_OK;
+	}
+#endif
+	if (glewStat != GLEW_OK) {
+		error = "Failed to initialize glew!";
+		Destroy();
+		return false;
+	}
+	// glewInit may leave an error behind on core profiles
+	glGetError();
+
+	glGenRenderbuffers(1, &colour);
+	glBindRenderbuffer(GL_RENDERBUFFER, colour);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+	glGenRenderbuffers(1, &depth);
+	glBindRenderbuffer(GL_RENDERBUFFER, depth);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colour);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		error = "Offscreen framebuffer is incomplete!";
+		Destroy();
+		return false;
+	}
+	return true;
+}
+
+void Engine::OffscreenContext::Destroy()
+{
+#ifdef OFFSCREEN_OSMESA
+	bool current = context != nullptr;
+#else
+	bool current = context != EGL_NO_CONTEXT;
+#endif
+	if (current && framebuffer != 0) {
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glDeleteFramebuffers(1, &framebuffer);
+		glDeleteRenderbuffers(1, &colour);
+		glDeleteRenderbuffers(1, &depth);
+	}
+	framebuffer = colour = depth = 0;
+#ifdef OFFSCREEN_OSMESA
+	if (context != nullptr) {
+		OSMesaDestroyContext(context);
+		context = nullptr;
+	}
+	buffer.clear();
+#else
+	if (display != EGL_NO_DISPLAY) {
+		eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (context != EGL_NO_CONTEXT) {
+			eglDestroyContext(display, context);
+		}
+		eglTerminate(display);
+	}
+	context = EGL_NO_CONTEXT;
+	display = EGL_NO_DISPLAY;
+#endif
+}
+
+bool Engine::OffscreenContext::SaveImage(const string& path) const
+{
+	vector<unsigned char> pixels((size_t)width * height * 3);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+	ofstream file(path, ios::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+	file << "P6\n" << width << " " << height << "\n255\n";
+	// GL rows start at the bottom
+	for (unsigned int y = height; y-- > 0;) {
+		file.write((const char*)pixels.data() + (size_t)y * width * 3, (size_t)width * 3);
+	}
+	return file.good();
+}
@@ -0,0 +1,82 @@
+#include "Game.h"
+#include "Offscreen.h"
+
+// Kept apart from Game.cpp so only the benchmark builds need EGL or OSMesa.
+// Build this file together with Offscreen.cpp where either is available.
+
+void Engine::Game::RunOffscreen(unsigned int width, unsigned int height, unsigned int frames, float deltaTime, float warmupMs,
+	vector<OffscreenFrame>& results, const string& imagePath)
+{
+	// Build hosts have no sound card either, the mixer opens the dummy driver
+	SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+
+	this->screenWidth = width;
+	this->screenHeight = height;
+	this->timeScale = 1;
+
+	OffscreenContext offscreen;
+	string error;
+	if (!offscreen.Create(width, height, error)) {
+		Err(error);
+	}
+
+	assets.OpenArchive(ARCHIVE_NAME);
+	InitFrameUniforms();
+	programCache.Init();
+	Profiler& profiler = Profiler::Get();
+	profiler.InitGpu();
+
+	this->state = State::RUNNING;
+	frameCount = 0;
+
+	Init();
+	BeginPipeline();
+
+	results.clear();
+	results.reserve(frames);
+	auto start = chrono::steady_clock::now();
+	bool warm = warmupMs <= 0;
+	while (State::RUNNING == state && results.size() < frames) {
+		profiler.BeginFrame();
+		float frameDelta = deltaTime;
+		if (replay.IsPlaying() && !replay.NextFrame(frameDelta, replayEvents)) {
+			Quit();
+			profiler.EndFrame();
+			continue;
+		}
+		auto begin = chrono::steady_clock::now();
+		_previousKeyState = _keyState;
+		ApplyReplayEvents();
+		assets.Update();
+		future<void> update = BeginUpdate(frameDelta);
+		RenderFrame();
+		auto submitted = chrono::steady_clock::now();
+		// Software GL does the actual drawing here
+		glFinish();
+		auto finished = chrono::steady_clock::now();
+		// A pipelined update still running past the GL counts as CPU time
+		EndUpdate(update);
+		auto updated = chrono::steady_clock::now();
+		profiler.EndFrame();
+		frameCount++;
+
+		if (!warm) {
+			warm = chrono::duration<float, milli>(finished - start).count() >= warmupMs;
+			continue;
+		}
+		OffscreenFrame frame;
+		frame.cpuMs = chrono::duration<float, milli>((submitted - begin) + (updated - finished)).count();
+		frame.finishMs = chrono::duration<float, milli>(finished - submitted).count();
+		frame.counters = profiler.GetLastFrameCounters();
+		results.push_back(frame);
+	}
+
+	if (!imagePath.empty() && !offscreen.SaveImage(imagePath)) {
+		cout << "Unable to write " << imagePath << endl;
+	}
+
+	DeInit();
+	shaderWatcher.Stop();
+	recorder.Close();
+	replay.Close();
+}
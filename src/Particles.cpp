@@ -0,0 +1,223 @@
+#include "Particles.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+// Streams of the instance buffer, each capacity elements long
+enum ParticleStream { STREAM_X, STREAM_Y, STREAM_SIZE, STREAM_LIFE, STREAM_COLOR, STREAM_COUNT };
+
+Engine::ParticleSystem::ParticleSystem(size_t capacity, uint64_t seed) : capacity(capacity), random(seed)
+{
+	for (vector<float>* stream : { &x, &y, &vx, &vy, &age, &invLife, &sizeStart, &sizeDelta, &size, &life }) {
+		stream->resize(capacity);
+	}
+	colors.resize(capacity);
+}
+
+Engine::ParticleSystem::~ParticleSystem()
+{
+	if (VAO != 0) {
+		glDeleteVertexArrays(1, &VAO);
+		glDeleteBuffers(1, &quadVBO);
+		glDeleteBuffers(1, &instanceVBO);
+	}
+}
+
+void Engine::ParticleSystem::Init()
+{
+	// Same unit quad as the sprites, centred on the particle by the shader
+	GLfloat corners[] = {
+		0.0f, 0.0f, // Top Left
+		1.0f, 0.0f, // Top Right
+		0.0f, 1.0f, // Bottom Left
+		1.0f, 1.0f  // Bottom Right
+	};
+
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &quadVBO);
+	glGenBuffers(1, &instanceVBO);
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (GLvoid*)0);
+
+	// Every stream sits at a fixed offset, so the pointers never change after this
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * capacity * STREAM_COUNT, NULL, GL_STREAM_DRAW);
+	for (GLuint stream = STREAM_X; stream < STREAM_COUNT; stream++) {
+		GLuint attribute = stream + 1;
+		glEnableVertexAttribArray(attribute);
+		glVertexAttribDivisor(attribute, 1);
+		GLvoid* offset = (GLvoid*)(sizeof(GLfloat) * capacity * stream);
+		if (stream == STREAM_COLOR) {
+			glVertexAttribPointer(attribute, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(uint32_t), offset);
+		}
+		else {
+			glVertexAttribPointer(attribute, 1, GL_FLOAT, GL_FALSE, sizeof(GLfloat), offset);
+		}
+	}
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+size_t Engine::ParticleSystem::Emit(const ParticleBurst& burst, vec2 position, size_t count)
+{
+	count = std::min(count, capacity - this->count);
+	// Bytes in memory order, read back as RGBA by the normalised attribute
+	uint8_t rgba[4];
+	for (int i = 0; i < 4; i++) {
+		rgba[i] = (uint8_t)(std::min(std::max(burst.color[i], 0.0f), 1.0f) * 255);
+	}
+	uint32_t color;
+	memcpy(&color, rgba, sizeof(color));
+
+	for (size_t n = 0; n < count; n++) {
+		size_t i = this->count + n;
+		// Evenly spaced with some jitter, a burst looks round even with few particles
+		float angle = burst.direction + burst.spread * ((n + random.NextFloat()) / count - 0.5f);
+		float speed = burst.speedMin + (burst.speedMax - burst.speedMin) * random.NextFloat();
+		x[i] = position.x;
+		y[i] = position.y;
+		vx[i] = cos(angle) * speed;
+		vy[i] = sin(angle) * speed;
+		age[i] = 0;
+		invLife[i] = 1.0f / std::max(burst.lifeMin + (burst.lifeMax - burst.lifeMin) * random.NextFloat(), 1.0f);
+		sizeStart[i] = burst.sizeStart;
+		sizeDelta[i] = burst.sizeEnd - burst.sizeStart;
+		size[i] = burst.sizeStart;
+		life[i] = 0;
+		colors[i] = color;
+	}
+	this->count += count;
+	return count;
+}
+
+void Engine::ParticleSystem::Integrate(size_t first, size_t last, float seconds, float dragFactor)
+{
+	// Local restrict pointers, otherwise the compiler has to assume the arrays overlap
+	float* __restrict px = x.data();
+	float* __restrict py = y.data();
+	float* __restrict pvx = vx.data();
+	float* __restrict pvy = vy.data();
+	float* __restrict page = age.data();
+	float* __restrict plife = life.data();
+	float* __restrict psize = size.data();
+	const float* __restrict pinvLife = invLife.data();
+	const float* __restrict psizeStart = sizeStart.data();
+	const float* __restrict psizeDelta = sizeDelta.data();
+	float gx = gravity.x * seconds, gy = gravity.y * seconds, ms = seconds * 1000.0f;
+
+	for (size_t i = first; i < last; i++) {
+		pvx[i] = (pvx[i] + gx) * dragFactor;
+		pvy[i] = (pvy[i] + gy) * dragFactor;
+		px[i] += pvx[i] * seconds;
+		py[i] += pvy[i] * seconds;
+		page[i] += ms;
+		plife[i] = page[i] * pinvLife[i];
+		psize[i] = psizeStart[i] + psizeDelta[i] * plife[i];
+	}
+}
+
+void Engine::ParticleSystem::Compact()
+{
+	// Keeps the order, so overlapping particles never swap places between frames
+	size_t live = 0;
+	for (size_t i = 0; i < count; i++) {
+		if (life[i] >= 1.0f) {
+			continue;
+		}
+		if (live != i) {
+			x[live] = x[i];
+			y[live] = y[i];
+			vx[live] = vx[i];
+			vy[live] = vy[i];
+			age[live] = age[i];
+			invLife[live] = invLife[i];
+			sizeStart[live] = sizeStart[i];
+			sizeDelta[live] = sizeDelta[i];
+			size[live] = size[i];
+			life[live] = life[i];
+			colors[live] = colors[i];
+		}
+		live++;
+	}
+	count = live;
+}
+
+void Engine::ParticleSystem::Update(float deltaTime, ThreadPool* pool)
+{
+	PROFILE_SCOPE("Particles");
+	float seconds = deltaTime * 0.001f;
+	float dragFactor = pow(drag, seconds);
+
+	if (pool == nullptr || count < PARTICLES_PARALLEL_MIN) {
+		Integrate(0, count, seconds, dragFactor);
+	}
+	else {
+		// One chunk per worker plus one for the caller, which helps while it waits.
+		// Chunks are multiples of 64 particles so no two threads share a cache line
+		size_t chunks = pool->GetWorkerCount() + 1;
+		size_t chunkSize = ((count + chunks - 1) / chunks + 63) & ~(size_t)63;
+		vector<future<void>> tasks;
+		for (size_t first = 0; first < count; first += chunkSize) {
+			size_t last = std::min(first + chunkSize, count);
+			tasks.push_back(pool->Async([this, first, last, seconds, dragFactor]() {
+				Integrate(first, last, seconds, dragFactor);
+			}));
+		}
+		for (future<void>& task : tasks) {
+			pool->Wait(task);
+		}
+	}
+	Compact();
+}
+
+void Engine::ParticleSystem::CopyDrawState(const ParticleSystem& source)
+{
+	count = std::min(source.count, capacity);
+	copy_n(source.x.begin(), count, x.begin());
+	copy_n(source.y.begin(), count, y.begin());
+	copy_n(source.size.begin(), count, size.begin());
+	copy_n(source.life.begin(), count, life.begin());
+	copy_n(source.colors.begin(), count, colors.begin());
+}
+
+void Engine::ParticleSystem::Submit(RenderQueue& queue, RenderPass pass, int layer, Shader* shader, BlendMode blend)
+{
+	if (count == 0) {
+		return;
+	}
+	Material material = { shader, 0, blend };
+	queue.Submit(pass, layer, material, &ParticleSystem::Draw, this);
+}
+
+void Engine::ParticleSystem::Draw(void* owner, uint32_t argument, StateCache& state)
+{
+	ParticleSystem* system = (ParticleSystem*)owner;
+	size_t count = system->count;
+	state.BindArrayBuffer(system->instanceVBO);
+
+	// The whole buffer is rewritten every frame, orphaning it means never waiting on last frame's draw
+	char* dst = (char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, sizeof(GLfloat) * system->capacity * STREAM_COUNT,
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if (dst == nullptr) {
+		// Out of memory or a lost context, the particles are skipped this frame
+		return;
+	}
+	const void* streams[STREAM_COUNT] = { system->x.data(), system->y.data(), system->size.data(), system->life.data(), system->colors.data() };
+	for (int stream = STREAM_X; stream < STREAM_COUNT; stream++) {
+		memcpy(dst + sizeof(GLfloat) * system->capacity * stream, streams[stream], sizeof(GLfloat) * count);
+	}
+	glUnmapBuffer(GL_ARRAY_BUFFER);
+
+	state.BindVertexArray(system->VAO);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)count);
+
+	Profiler& profiler = Profiler::Get();
+	profiler.CountUpload(sizeof(GLfloat) * count * STREAM_COUNT);
+	profiler.CountDrawCall();
+}
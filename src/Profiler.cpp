@@ -0,0 +1,207 @@
+#include "Profiler.h"
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+
+static thread_local uint32_t profileDepth = 0;
+
+Engine::Profiler& Engine::Profiler::Get()
+{
+	static Profiler profiler;
+	return profiler;
+}
+
+Engine::Profiler::Profiler() : writeIndex(0)
+{
+	samples = new Slot[PROFILER_MAX_SAMPLES];
+	for (int i = 0; i < PROFILER_MAX_SAMPLES; i++) {
+		samples[i].sequence.store(0, memory_order_relaxed);
+	}
+	ticksToMs = 1000.0 / SDL_GetPerformanceFrequency();
+	frameBegin = Now();
+}
+
+uint32_t Engine::Profiler::GetThreadID()
+{
+	static atomic<uint32_t> nextThread(1);
+	static thread_local uint32_t thread = nextThread.fetch_add(1);
+	return thread;
+}
+
+void Engine::Profiler::Record(const char* name, uint64_t begin, uint64_t end, uint32_t depth)
+{
+	Push({ name, begin, end, GetThreadID(), depth });
+}
+
+void Engine::Profiler::Push(const ProfileSample& sample)
+{
+	// Claim a slot, then publish it by writing its sequence last. Readers skip
+	// slots whose sequence does not match the index they expect.
+	uint64_t index = writeIndex.fetch_add(1, memory_order_relaxed);
+	Slot& slot = samples[index & (PROFILER_MAX_SAMPLES - 1)];
+	slot.sequence.store(0, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	slot.name.store(sample.name, memory_order_relaxed);
+	slot.begin.store(sample.begin, memory_order_relaxed);
+	slot.end.store(sample.end, memory_order_relaxed);
+	slot.thread.store(sample.thread, memory_order_relaxed);
+	slot.depth.store(sample.depth, memory_order_relaxed);
+	slot.sequence.store(index + 1, memory_order_release);
+}
+
+void Engine::Profiler::InitGpu()
+{
+	for (int frame = 0; frame < PROFILER_GPU_LATENCY; frame++) {
+		for (int i = 0; i < PROFILER_MAX_GPU_SCOPES; i++) {
+			glGenQueries(2, gpuScopes[frame][i].queries);
+		}
+	}
+	// Pair a GPU timestamp with a CPU one so both end up on the same time line
+	glGetInteger64v(GL_TIMESTAMP, &gpuSyncTime);
+	gpuSyncTicks = Now();
+	gpuEnabled = true;
+}
+
+void Engine::Profiler::BeginFrame()
+{
+	uint64_t now = Now();
+	if (frameCount > 0) {
+		unsigned int index = (unsigned int)((frameCount - 1) % PROFILER_MAX_FRAMES);
+		frameTimes[index] = (float)((now - frameBegin) * ticksToMs);
+	}
+	frameBegin = now;
+
+	if (gpuEnabled) {
+		// This slot was filled PROFILER_GPU_LATENCY frames ago, its results should be ready
+		unsigned int frameSlot = frameCount % PROFILER_GPU_LATENCY;
+		if (frameCount >= PROFILER_GPU_LATENCY) {
+			ReadGpuFrame(frameSlot);
+		}
+		gpuScopeCount[frameSlot] = 0;
+		gpuDepth = 0;
+	}
+	current = FrameCounters();
+}
+
+void Engine::Profiler::EndFrame()
+{
+	last = current;
+	frameCounters[frameCount % PROFILER_MAX_FRAMES] = current;
+	frameCount++;
+}
+
+void Engine::Profiler::BeginGpuScope(const char* name)
+{
+	unsigned int frameSlot = frameCount % PROFILER_GPU_LATENCY;
+	if (!gpuEnabled || gpuScopeCount[frameSlot] == PROFILER_MAX_GPU_SCOPES) {
+		return;
+	}
+	unsigned int index = gpuScopeCount[frameSlot]++;
+	GpuScope& scope = gpuScopes[frameSlot][index];
+	scope.name = name;
+	scope.depth = gpuDepth;
+	// Timestamps instead of GL_TIME_ELAPSED so scopes can nest
+	glQueryCounter(scope.queries[0], GL_TIMESTAMP);
+	gpuStack[gpuDepth++] = index;
+}
+
+void Engine::Profiler::EndGpuScope()
+{
+	if (!gpuEnabled || gpuDepth == 0) {
+		return;
+	}
+	unsigned int frameSlot = frameCount % PROFILER_GPU_LATENCY;
+	glQueryCounter(gpuScopes[frameSlot][gpuStack[--gpuDepth]].queries[1], GL_TIMESTAMP);
+}
+
+void Engine::Profiler::ReadGpuFrame(unsigned int frameSlot)
+{
+	double ticksPerNs = SDL_GetPerformanceFrequency() / 1e9;
+	for (unsigned int i = 0; i < gpuScopeCount[frameSlot]; i++) {
+		GpuScope& scope = gpuScopes[frameSlot][i];
+		GLint available = 0;
+		glGetQueryObjectiv(scope.queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) {
+			continue;
+		}
+		GLuint64 begin = 0, end = 0;
+		glGetQueryObjectui64v(scope.queries[0], GL_QUERY_RESULT, &begin);
+		glGetQueryObjectui64v(scope.queries[1], GL_QUERY_RESULT, &end);
+		uint64_t beginTicks = gpuSyncTicks + (uint64_t)(((int64_t)begin - gpuSyncTime) * ticksPerNs);
+		uint64_t endTicks = gpuSyncTicks + (uint64_t)(((int64_t)end - gpuSyncTime) * ticksPerNs);
+		Push({ scope.name, beginTicks, endTicks, PROFILER_GPU_THREAD, scope.depth });
+	}
+}
+
+bool Engine::Profiler::ExportChromeTrace(const string& path)
+{
+	ofstream file(path);
+	if (!file) {
+		return false;
+	}
+
+	uint64_t end = writeIndex.load(memory_order_acquire);
+	uint64_t begin = end > PROFILER_MAX_SAMPLES ? end - PROFILER_MAX_SAMPLES : 0;
+	double ticksToUs = ticksToMs * 1000.0;
+
+	file << "{\"traceEvents\":[" << endl;
+	file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << PROFILER_GPU_THREAD << ",\"args\":{\"name\":\"GPU\"}}";
+	for (uint64_t index = begin; index < end; index++) {
+		Slot& slot = samples[index & (PROFILER_MAX_SAMPLES - 1)];
+		if (slot.sequence.load(memory_order_acquire) != index + 1) {
+			continue;
+		}
+		ProfileSample sample = {
+			slot.name.load(memory_order_relaxed),
+			slot.begin.load(memory_order_relaxed),
+			slot.end.load(memory_order_relaxed),
+			slot.thread.load(memory_order_relaxed),
+			slot.depth.load(memory_order_relaxed)
+		};
+		// Overwritten while copying
+		atomic_thread_fence(memory_order_acquire);
+		if (slot.sequence.load(memory_order_relaxed) != index + 1) {
+			continue;
+		}
+		file << "," << endl << "{\"name\":\"" << sample.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << sample.thread
+			<< ",\"ts\":" << (uint64_t)(sample.begin * ticksToUs) << ",\"dur\":" << (uint64_t)((sample.end - sample.begin) * ticksToUs) << "}";
+	}
+	file << endl << "]}" << endl;
+	return (bool)file;
+}
+
+void Engine::Profiler::PrintSummary()
+{
+	uint64_t frames = frameCount > 1 ? min<uint64_t>(frameCount - 1, PROFILER_MAX_FRAMES) : 0;
+	if (frames == 0) {
+		return;
+	}
+	vector<float> times(frameTimes, frameTimes + frames);
+	sort(times.begin(), times.end());
+	double drawCalls = 0, stateChanges = 0, uploadBytes = 0;
+	for (uint64_t i = 0; i < frames; i++) {
+		drawCalls += frameCounters[i].drawCalls;
+		stateChanges += frameCounters[i].stateChanges;
+		uploadBytes += (double)frameCounters[i].uploadBytes;
+	}
+
+	cout << "Frame time over " << frames << " frames: p50 " << times[frames / 2] << " ms, p99 "
+		<< times[(size_t)(frames * 99 / 100)] << " ms, max " << times.back() << " ms" << endl;
+	cout << "Per frame: " << drawCalls / frames << " draw calls, " << stateChanges / frames << " state changes, "
+		<< uploadBytes / frames << " bytes uploaded" << endl;
+}
+
+Engine::ProfileScope::ProfileScope(const char* name) : name(name)
+{
+	begin = SDL_GetPerformanceCounter();
+	profileDepth++;
+}
+
+Engine::ProfileScope::~ProfileScope()
+{
+	profileDepth--;
+	Profiler::Get().Record(name, begin, SDL_GetPerformanceCounter(), profileDepth);
+}
@@ -0,0 +1,145 @@
+#include "ProgramCache.h"
+
+#include <fstream>
+#include <vector>
+#include <cstdio>
+#include <filesystem>
+
+
+struct ProgramCacheHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t key;
+	uint32_t format;
+	uint32_t length;
+};
+
+Engine::ProgramCache::ProgramCache()
+{
+}
+
+
+Engine::ProgramCache::~ProgramCache()
+{
+}
+
+void Engine::ProgramCache::Init()
+{
+	GLint formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	enabled = formats > 0;
+	if (!enabled) {
+		return;
+	}
+
+	// A binary is only valid for the driver that produced it
+	const char* vendor = (const char*)glGetString(GL_VENDOR);
+	const char* renderer = (const char*)glGetString(GL_RENDERER);
+	const char* version = (const char*)glGetString(GL_VERSION);
+	driver = string(vendor ? vendor : "") + "|" + (renderer ? renderer : "") + "|" + (version ? version : "");
+
+	error_code ec;
+	filesystem::create_directories(PROGRAM_CACHE_DIR, ec);
+	if (ec) {
+		enabled = false;
+	}
+}
+
+uint64_t Engine::ProgramCache::Hash(const void* data, size_t length, uint64_t seed)
+{
+	// FNV-1a
+	const unsigned char* bytes = (const unsigned char*)data;
+	uint64_t hash = seed;
+	for (size_t i = 0; i < length; i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+uint64_t Engine::ProgramCache::MakeKey(const string& vertexCode, const string& fragmentCode, const string& geometryCode) const
+{
+	// The separators keep "ab"+"c" and "a"+"bc" from colliding
+	uint64_t key = Hash(driver.data(), driver.size());
+	key = Hash("\0v", 2, key);
+	key = Hash(vertexCode.data(), vertexCode.size(), key);
+	key = Hash("\0f", 2, key);
+	key = Hash(fragmentCode.data(), fragmentCode.size(), key);
+	key = Hash("\0g", 2, key);
+	key = Hash(geometryCode.data(), geometryCode.size(), key);
+	return key;
+}
+
+string Engine::ProgramCache::GetPath(uint64_t key) const
+{
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+	return string(PROGRAM_CACHE_DIR) + "/" + name;
+}
+
+bool Engine::ProgramCache::Load(uint64_t key, GLuint program)
+{
+	if (!enabled) {
+		return false;
+	}
+
+	ifstream file(GetPath(key), ios::binary | ios::ate);
+	if (!file) {
+		return false;
+	}
+	streamoff size = file.tellg();
+	file.seekg(0);
+	ProgramCacheHeader header;
+	if (!file.read((char*)&header, sizeof(header)) || header.magic != PROGRAM_CACHE_MAGIC
+		|| header.version != PROGRAM_CACHE_VERSION || header.key != key) {
+		return false;
+	}
+	// A damaged length must not decide how much we allocate, the rest of the file has to match it
+	if (header.length == 0 || (streamoff)header.length != size - (streamoff)sizeof(header)) {
+		return false;
+	}
+	vector<char> binary(header.length);
+	if (!file.read(binary.data(), header.length)) {
+		return false;
+	}
+
+	glProgramBinary(program, header.format, binary.data(), header.length);
+	// Drivers reject binaries after an update, we then simply compile again
+	GLint success = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	return success == GL_TRUE;
+}
+
+void Engine::ProgramCache::Save(uint64_t key, GLuint program)
+{
+	if (!enabled) {
+		return;
+	}
+
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) {
+		return;
+	}
+	vector<char> binary(length);
+	GLenum format = 0;
+	glGetProgramBinary(program, length, NULL, &format, binary.data());
+
+	// Write to a temporary file first so a crash never leaves a truncated entry
+	string path = GetPath(key);
+	string tempPath = path + ".tmp";
+	{
+		ofstream file(tempPath, ios::binary | ios::trunc);
+		if (!file) {
+			return;
+		}
+		ProgramCacheHeader header = { PROGRAM_CACHE_MAGIC, PROGRAM_CACHE_VERSION, key, format, (uint32_t)length };
+		file.write((const char*)&header, sizeof(header));
+		file.write(binary.data(), length);
+		if (!file) {
+			return;
+		}
+	}
+	error_code ec;
+	filesystem::rename(tempPath, path, ec);
+}
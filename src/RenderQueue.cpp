@@ -0,0 +1,147 @@
+#include "RenderQueue.h"
+#include "Profiler.h"
+
+#include <algorithm>
+
+
+void Engine::StateCache::Invalidate()
+{
+	InvalidateBindings();
+	// Never a valid name, the next call always goes through
+	program = ~0u;
+	blendKnown = false;
+	clearColorKnown = false;
+}
+
+void Engine::StateCache::InvalidateBindings()
+{
+	vertexArray = ~0u;
+	arrayBuffer = ~0u;
+	for (GLuint& texture : textures) {
+		texture = ~0u;
+	}
+	activeUnit = ~0u;
+}
+
+void Engine::StateCache::UseProgram(GLuint program)
+{
+	if (program != this->program) {
+		glUseProgram(program);
+		this->program = program;
+		Profiler::Get().CountStateChange();
+	}
+}
+
+void Engine::StateCache::BindVertexArray(GLuint vertexArray)
+{
+	if (vertexArray != this->vertexArray) {
+		glBindVertexArray(vertexArray);
+		this->vertexArray = vertexArray;
+		Profiler::Get().CountStateChange();
+	}
+}
+
+void Engine::StateCache::BindArrayBuffer(GLuint buffer)
+{
+	if (buffer != arrayBuffer) {
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+		arrayBuffer = buffer;
+		Profiler::Get().CountStateChange();
+	}
+}
+
+void Engine::StateCache::BindTexture(unsigned int unit, GLuint texture)
+{
+	if (texture == textures[unit]) {
+		return;
+	}
+	if (unit != activeUnit) {
+		glActiveTexture(GL_TEXTURE0 + unit);
+		activeUnit = unit;
+	}
+	glBindTexture(GL_TEXTURE_2D, texture);
+	textures[unit] = texture;
+	Profiler::Get().CountStateChange();
+}
+
+void Engine::StateCache::SetBlend(BlendMode mode)
+{
+	if (blendKnown && mode == blend) {
+		return;
+	}
+	switch (mode) {
+	case BlendMode::REPLACE:
+		glDisable(GL_BLEND);
+		break;
+	case BlendMode::ALPHA:
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		break;
+	case BlendMode::ADDITIVE:
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+		break;
+	}
+	blend = mode;
+	blendKnown = true;
+	Profiler::Get().CountStateChange();
+}
+
+void Engine::StateCache::SetClearColor(const vec4& color)
+{
+	if (clearColorKnown && color == clearColor) {
+		return;
+	}
+	glClearColor(color.r, color.g, color.b, color.a);
+	clearColor = color;
+	clearColorKnown = true;
+	Profiler::Get().CountStateChange();
+}
+
+Engine::RenderQueue::RenderQueue()
+{
+	commands.reserve(RENDERQUEUE_INITIAL_CAPACITY);
+	keys.reserve(RENDERQUEUE_INITIAL_CAPACITY);
+}
+
+void Engine::RenderQueue::Submit(RenderPass pass, int layer, const Material& material, RenderCallback callback, void* owner, uint32_t argument)
+{
+	uint64_t sequence = commands.size();
+	uint64_t shader = material.shader != nullptr ? material.shader->GetProgram() : 0;
+	uint64_t key = ((uint64_t)(pass & 0xF) << 60)
+		| ((uint64_t)((layer + 128) & 0xFF) << 52)
+		| ((shader & 0x3FF) << 42)
+		| (((uint64_t)material.texture & 0xFFFF) << 26)
+		| (((uint64_t)material.blend & 0xF) << RENDERQUEUE_SEQUENCE_BITS)
+		| sequence;
+	keys.push_back(key);
+	commands.push_back({ material, callback, owner, argument });
+}
+
+void Engine::RenderQueue::Execute(StateCache& state)
+{
+	// Uploads between frames bind textures and buffers without the cache
+	state.InvalidateBindings();
+	materialChanges = 0;
+	// Sorting the bare keys is cheaper than moving commands around
+	sort(keys.begin(), keys.end());
+
+	const Material* bound = nullptr;
+	for (uint64_t key : keys) {
+		const RenderCommand& command = commands[key & ((1ULL << RENDERQUEUE_SEQUENCE_BITS) - 1)];
+		const Material& material = command.material;
+		if (bound == nullptr || material.shader != bound->shader || material.texture != bound->texture || material.blend != bound->blend) {
+			if (material.shader != nullptr) {
+				state.UseProgram(material.shader->GetProgram());
+			}
+			state.BindTexture(0, material.texture);
+			state.SetBlend(material.blend);
+			bound = &material;
+			materialChanges++;
+		}
+		command.callback(command.owner, command.argument, state);
+	}
+
+	commands.clear();
+	keys.clear();
+}
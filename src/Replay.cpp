@@ -0,0 +1,194 @@
+#include "Replay.h"
+
+#include <cstring>
+
+
+static int64_t UnZigZag(uint64_t value)
+{
+	return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static uint64_t ZigZag(int64_t value)
+{
+	return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+Engine::InputRecorder::~InputRecorder()
+{
+	Close();
+}
+
+bool Engine::InputRecorder::Open(const string& path, uint64_t seed)
+{
+	Close();
+	file.open(path, ios::binary | ios::trunc);
+	if (!file.is_open()) {
+		return false;
+	}
+	buffer.clear();
+	for (int i = 0; i < 4; i++) {
+		buffer.push_back((uint8_t)REPLAY_MAGIC[i]);
+	}
+	buffer.push_back(REPLAY_VERSION);
+	// Little endian whatever the host
+	for (int i = 0; i < 8; i++) {
+		buffer.push_back((uint8_t)(seed >> (i * 8)));
+	}
+	inFrame = false;
+	return true;
+}
+
+void Engine::InputRecorder::Close()
+{
+	if (!file.is_open()) {
+		return;
+	}
+	if (inFrame) {
+		WriteFrame();
+		inFrame = false;
+	}
+	file.write((const char*)buffer.data(), buffer.size());
+	buffer.clear();
+	file.close();
+}
+
+void Engine::InputRecorder::BeginFrame(float deltaTime)
+{
+	if (!file.is_open()) {
+		return;
+	}
+	if (inFrame) {
+		WriteFrame();
+	}
+	this->deltaTime = deltaTime;
+	inFrame = true;
+	if (buffer.size() >= REPLAY_FLUSH_SIZE) {
+		file.write((const char*)buffer.data(), buffer.size());
+		buffer.clear();
+	}
+}
+
+void Engine::InputRecorder::Record(const InputEvent& event)
+{
+	if (inFrame) {
+		events.push_back(event);
+	}
+}
+
+void Engine::InputRecorder::WriteFrame()
+{
+	// The exact bits, so a replay accumulates the same fixed steps
+	uint32_t bits;
+	memcpy(&bits, &deltaTime, sizeof(bits));
+	for (int i = 0; i < 4; i++) {
+		buffer.push_back((uint8_t)(bits >> (i * 8)));
+	}
+	WriteVarint(events.size());
+	for (const InputEvent& event : events) {
+		buffer.push_back(event.type);
+		if (event.type == INPUT_MOUSE) {
+			WriteVarint(ZigZag(event.x));
+			WriteVarint(ZigZag(event.y));
+		}
+		else {
+			WriteVarint(event.key);
+		}
+	}
+	events.clear();
+}
+
+void Engine::InputRecorder::WriteVarint(uint64_t value)
+{
+	while (value >= 0x80) {
+		buffer.push_back((uint8_t)(value | 0x80));
+		value >>= 7;
+	}
+	buffer.push_back((uint8_t)value);
+}
+
+bool Engine::InputReplay::Open(const string& path)
+{
+	Close();
+	ifstream file(path, ios::binary | ios::ate);
+	if (!file.is_open()) {
+		return false;
+	}
+	data.resize((size_t)file.tellg());
+	file.seekg(0);
+	file.read((char*)data.data(), data.size());
+	if (!file || data.size() < 13 || memcmp(data.data(), REPLAY_MAGIC, 4) != 0 || data[4] != REPLAY_VERSION) {
+		data.clear();
+		return false;
+	}
+	seed = 0;
+	for (int i = 0; i < 8; i++) {
+		seed |= (uint64_t)data[5 + i] << (i * 8);
+	}
+	position = 13;
+	playing = true;
+	return true;
+}
+
+void Engine::InputReplay::Close()
+{
+	data.clear();
+	position = 0;
+	playing = false;
+}
+
+bool Engine::InputReplay::NextFrame(float& deltaTime, vector<InputEvent>& events)
+{
+	events.clear();
+	if (!playing || position + 4 > data.size()) {
+		playing = false;
+		return false;
+	}
+	uint32_t bits = 0;
+	for (int i = 0; i < 4; i++) {
+		bits |= (uint32_t)data[position++] << (i * 8);
+	}
+	memcpy(&deltaTime, &bits, sizeof(deltaTime));
+	uint64_t count;
+	if (!ReadVarint(count)) {
+		playing = false;
+		return false;
+	}
+	for (uint64_t i = 0; i < count; i++) {
+		if (position >= data.size()) {
+			playing = false;
+			return false;
+		}
+		InputEvent event = { (InputEventType)data[position++], 0, 0, 0 };
+		uint64_t a, b;
+		if (event.type == INPUT_MOUSE) {
+			if (!ReadVarint(a) || !ReadVarint(b)) {
+				playing = false;
+				return false;
+			}
+			event.x = (int)UnZigZag(a);
+			event.y = (int)UnZigZag(b);
+		}
+		else {
+			if (!ReadVarint(a)) {
+				playing = false;
+				return false;
+			}
+			event.key = (unsigned int)a;
+		}
+		events.push_back(event);
+	}
+	return true;
+}
+
+bool Engine::InputReplay::ReadVarint(uint64_t& value)
+{
+	value = 0;
+	for (int shift = 0; shift < 64 && position < data.size(); shift += 7) {
+		uint8_t byte = data[position++];
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,134 @@
+#include "Shader.h"
+#include "Profiler.h"
+
+#include <cstring>
+#include <GLM/gtc/type_ptr.hpp>
+
+
+Engine::Shader::Shader()
+{
+}
+
+
+Engine::Shader::~Shader()
+{
+	if (program != 0) {
+		glDeleteProgram(program);
+	}
+}
+
+void Engine::Shader::Attach(GLuint program)
+{
+	// Replacing the program on a hot reload keeps the handles given out so far valid
+	if (this->program != 0 && this->program != program) {
+		glDeleteProgram(this->program);
+	}
+	this->program = program;
+	for (Uniform& uniform : uniforms) {
+		uniform.location = -1;
+		uniform.cached = false;
+	}
+
+	GLint count = 0;
+	glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+	for (GLint i = 0; i < count; i++) {
+		GLchar name[256];
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(program, i, sizeof(name), &length, &size, &type, name);
+		GLint location = glGetUniformLocation(program, name);
+		// Uniforms that live in a block have no location
+		if (location < 0) {
+			continue;
+		}
+		// Arrays are reported as "name[0]", store them by their plain name
+		string uniformName(name, length);
+		size_t bracket = uniformName.find('[');
+		if (bracket != string::npos) {
+			uniformName = uniformName.substr(0, bracket);
+		}
+		auto it = uniformNames.find(uniformName);
+		if (it != uniformNames.end()) {
+			uniforms[it->second].location = location;
+			uniforms[it->second].type = type;
+		}
+		else {
+			Uniform uniform = { location, type, false, {} };
+			uniformNames[uniformName] = (int)uniforms.size();
+			uniforms.push_back(uniform);
+		}
+	}
+
+	// Route the shared per frame block to its binding point
+	GLuint blockIndex = glGetUniformBlockIndex(program, FRAME_UNIFORM_BLOCK);
+	if (blockIndex != GL_INVALID_INDEX) {
+		glUniformBlockBinding(program, blockIndex, FRAME_UNIFORM_BINDING);
+	}
+}
+
+int Engine::Shader::GetUniform(const string& name) const
+{
+	auto it = uniformNames.find(name);
+	if (it != uniformNames.end()) {
+		return it->second;
+	}
+	return -1;
+}
+
+bool Engine::Shader::Store(int uniform, const void* value, size_t size)
+{
+	if (uniform < 0) {
+		return false;
+	}
+	Uniform& u = uniforms[uniform];
+	if (u.cached && memcmp(u.value, value, size) == 0) {
+		return false;
+	}
+	memcpy(u.value, value, size);
+	u.cached = true;
+	Profiler::Get().CountStateChange();
+	return true;
+}
+
+void Engine::Shader::SetInt(int uniform, GLint value)
+{
+	if (Store(uniform, &value, sizeof(value))) {
+		glUniform1i(uniforms[uniform].location, value);
+	}
+}
+
+void Engine::Shader::SetFloat(int uniform, GLfloat value)
+{
+	if (Store(uniform, &value, sizeof(value))) {
+		glUniform1f(uniforms[uniform].location, value);
+	}
+}
+
+void Engine::Shader::SetVec2(int uniform, const vec2& value)
+{
+	if (Store(uniform, value_ptr(value), sizeof(GLfloat) * 2)) {
+		glUniform2fv(uniforms[uniform].location, 1, value_ptr(value));
+	}
+}
+
+void Engine::Shader::SetVec3(int uniform, const vec3& value)
+{
+	if (Store(uniform, value_ptr(value), sizeof(GLfloat) * 3)) {
+		glUniform3fv(uniforms[uniform].location, 1, value_ptr(value));
+	}
+}
+
+void Engine::Shader::SetVec4(int uniform, const vec4& value)
+{
+	if (Store(uniform, value_ptr(value), sizeof(GLfloat) * 4)) {
+		glUniform4fv(uniforms[uniform].location, 1, value_ptr(value));
+	}
+}
+
+void Engine::Shader::SetMat4(int uniform, const mat4& value)
+{
+	if (Store(uniform, value_ptr(value), sizeof(GLfloat) * 16)) {
+		glUniformMatrix4fv(uniforms[uniform].location, 1, GL_FALSE, value_ptr(value));
+	}
+}
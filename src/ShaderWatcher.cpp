@@ -0,0 +1,119 @@
+#include "ShaderWatcher.h"
+
+#include <chrono>
+#include <map>
+#include <filesystem>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+
+Engine::ShaderWatcher::ShaderWatcher() : running(false)
+{
+}
+
+
+Engine::ShaderWatcher::~ShaderWatcher()
+{
+	Stop();
+}
+
+void Engine::ShaderWatcher::Start(const vector<string>& paths)
+{
+	Stop();
+	this->paths = paths;
+	running = true;
+	worker = thread(&ShaderWatcher::Run, this);
+}
+
+void Engine::ShaderWatcher::Stop()
+{
+	running = false;
+	if (worker.joinable()) {
+		worker.join();
+	}
+}
+
+vector<string> Engine::ShaderWatcher::TakeChanged()
+{
+	lock_guard<mutex> lock(changedMutex);
+	vector<string> result(changed.begin(), changed.end());
+	changed.clear();
+	return result;
+}
+
+#ifdef __linux__
+void Engine::ShaderWatcher::Run()
+{
+	int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fd < 0) {
+		running = false;
+		return;
+	}
+
+	// Editors often replace the file instead of writing it, so watch the
+	// directories and match the file names
+	map<int, string> directories;
+	for (const string& path : paths) {
+		string directory = filesystem::path(path).parent_path().string();
+		if (directory.empty()) {
+			directory = ".";
+		}
+		int wd = inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+		if (wd >= 0) {
+			directories[wd] = directory;
+		}
+	}
+
+	alignas(inotify_event) char buffer[4096];
+	while (running) {
+		pollfd pfd = { fd, POLLIN, 0 };
+		if (poll(&pfd, 1, SHADER_WATCH_INTERVAL) <= 0) {
+			continue;
+		}
+		ssize_t length = read(fd, buffer, sizeof(buffer));
+		for (ssize_t offset = 0; offset < length;) {
+			const inotify_event* event = (const inotify_event*)(buffer + offset);
+			offset += sizeof(inotify_event) + event->len;
+			if (event->len == 0) {
+				continue;
+			}
+			filesystem::path written = filesystem::path(directories[event->wd]) / event->name;
+			for (const string& path : paths) {
+				error_code ec;
+				if (filesystem::path(path).filename() == written.filename()
+					&& filesystem::equivalent(written, path, ec)) {
+					lock_guard<mutex> lock(changedMutex);
+					changed.insert(path);
+				}
+			}
+		}
+	}
+
+	close(fd);
+}
+#else
+void Engine::ShaderWatcher::Run()
+{
+	// No inotify, compare modification times instead
+	map<string, filesystem::file_time_type> times;
+	error_code ec;
+	for (const string& path : paths) {
+		times[path] = filesystem::last_write_time(path, ec);
+	}
+
+	while (running) {
+		this_thread::sleep_for(chrono::milliseconds(SHADER_WATCH_INTERVAL));
+		for (const string& path : paths) {
+			filesystem::file_time_type time = filesystem::last_write_time(path, ec);
+			if (!ec && time != times[path]) {
+				times[path] = time;
+				lock_guard<mutex> lock(changedMutex);
+				changed.insert(path);
+			}
+		}
+	}
+}
+#endif
@@ -0,0 +1,213 @@
+#include "Solver.h"
+
+
+// Every search thread needs its own event buffer
+static thread_local Engine::CascadeResolver resolver;
+
+const uint64_t* Engine::Zobrist::GetKeys()
+{
+	// Fixed seed, hashes stay the same between runs
+	static const vector<uint64_t> keys = []() {
+		vector<uint64_t> keys(BOARD_MAX_HEIGHT * BOARD_MAX_COLOURS * BOARD_MAX_WIDTH);
+		Random random(0x5A0B21575EEDULL);
+		for (uint64_t& key : keys) {
+			key = random.Next();
+		}
+		return keys;
+	}();
+	return keys.data();
+}
+
+uint64_t Engine::Zobrist::Hash(const Board& board)
+{
+	const uint64_t* keys = GetKeys();
+	uint64_t hash = 0;
+	for (int y = 0; y < board.GetHeight(); y++) {
+		for (int c = 0; c < board.GetColourCount(); c++) {
+			const uint64_t* row = keys + (y * BOARD_MAX_COLOURS + c) * BOARD_MAX_WIDTH;
+			for (uint64_t bits = board.GetRow(y, c); bits; bits &= bits - 1) {
+				hash ^= row[LowestBit(bits)];
+			}
+		}
+	}
+	return hash;
+}
+
+Engine::TranspositionTable::TranspositionTable(unsigned int bits) : slots((size_t)1 << bits), mask(((uint64_t)1 << bits) - 1)
+{
+	Clear();
+}
+
+bool Engine::TranspositionTable::Probe(uint64_t key, int depth, float& value) const
+{
+	const Slot& slot = slots[key & mask];
+	uint64_t data = slot.data.load(memory_order_relaxed);
+	if ((slot.check.load(memory_order_relaxed) ^ data) != key || (int)(data >> 32) != depth) {
+		return false;
+	}
+	uint32_t bits = (uint32_t)data;
+	memcpy(&value, &bits, sizeof(value));
+	return true;
+}
+
+void Engine::TranspositionTable::Store(uint64_t key, int depth, float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	uint64_t data = ((uint64_t)depth << 32) | bits;
+	// Always replace, the newest result is the one most likely to be asked for again
+	Slot& slot = slots[key & mask];
+	slot.check.store(key ^ data, memory_order_relaxed);
+	slot.data.store(data, memory_order_relaxed);
+}
+
+void Engine::TranspositionTable::Clear()
+{
+	// Depth 0 is never probed, so zeroed slots never match
+	for (Slot& slot : slots) {
+		slot.check.store(0, memory_order_relaxed);
+		slot.data.store(0, memory_order_relaxed);
+	}
+}
+
+Engine::Solver::Solver(ThreadPool& pool) : pool(pool), aborted(false), nodes(0), iteration(0)
+{
+}
+
+void Engine::Solver::SetSamples(int samples)
+{
+	// Stored values were averaged over the old sample count
+	this->samples = samples;
+	table.Clear();
+}
+
+bool Engine::Solver::Expired() const
+{
+	// The first iteration always finishes so there is a move to play
+	return budgetMs > 0 && iteration > 1 && chrono::steady_clock::now() >= deadline;
+}
+
+float Engine::Solver::Sample(const Board& board, uint64_t hash, const Move& move, int sample, int depth)
+{
+	Board next = board;
+	int x2 = move.vertical ? move.x : move.x + 1;
+	int y2 = move.vertical ? move.y + 1 : move.y;
+	next.Swap(move.x, move.y, x2, y2);
+	// Same board, swap and sample always refill the same way, so the table stays consistent
+	Random random(hash ^ ((uint64_t)move.x << 40 | (uint64_t)move.y << 48 | (uint64_t)move.vertical << 56) ^ (uint64_t)sample);
+	resolver.ResolveSwap(next, random, move.x, move.y, x2, y2);
+	float cleared = (float)resolver.GetClearedCount();
+	if (depth <= 1) {
+		return cleared;
+	}
+	return cleared + SOLVER_DISCOUNT * Search(next, Zobrist::Hash(next), depth - 1);
+}
+
+float Engine::Solver::Search(const Board& board, uint64_t hash, int depth)
+{
+	nodes++;
+	if (aborted) {
+		return 0;
+	}
+	if (Expired()) {
+		aborted = true;
+		return 0;
+	}
+	float value;
+	if (table.Probe(hash, depth, value)) {
+		return value;
+	}
+
+	// A deadlocked board gets reshuffled, which clears nothing
+	float best = 0;
+	MoveMask moves;
+	MoveGenerator::Generate(board, moves);
+	for (int y = 0; y < board.GetHeight(); y++) {
+		for (int vertical = 0; vertical < 2; vertical++) {
+			for (uint64_t row = vertical ? moves.vertical[y] : moves.horizontal[y]; row; row &= row - 1) {
+				Move move = { (uint8_t)LowestBit(row), (uint8_t)y, vertical != 0 };
+				float total = 0;
+				for (int s = 0; s < samples; s++) {
+					total += Sample(board, hash, move, s, depth);
+				}
+				if (total / samples > best) {
+					best = total / samples;
+				}
+			}
+		}
+	}
+	// An aborted subtree is missing values and must not be reused
+	if (!aborted) {
+		table.Store(hash, depth, best);
+	}
+	return best;
+}
+
+Engine::SolverResult Engine::Solver::Solve(const Board& board)
+{
+	SolverResult result = {};
+	nodes = 0;
+	aborted = false;
+	deadline = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double, milli>(budgetMs));
+
+	vector<Move> moves;
+	MoveGenerator::List(board, moves);
+	result.moveCount = (unsigned int)moves.size();
+	if (moves.empty()) {
+		return result;
+	}
+	uint64_t hash = Zobrist::Hash(board);
+
+	vector<RootMove> roots(moves.size());
+	for (int depth = 1; depth <= maxDepth; depth++) {
+		iteration = depth;
+		for (size_t i = 0; i < moves.size(); i++) {
+			Move move = moves[i];
+			roots[i].move = move;
+			roots[i].samples.clear();
+			for (int s = 0; s < samples; s++) {
+				roots[i].samples.push_back(pool.Async([this, &board, hash, move, s, depth]() {
+					return Sample(board, hash, move, s, depth);
+				}));
+			}
+		}
+
+		// Every task refers to board, so all of them are waited for even after an abort
+		float best = -1, sum = 0;
+		Move bestMove = moves[0];
+		for (RootMove& root : roots) {
+			float total = 0;
+			for (future<float>& sample : root.samples) {
+				pool.Wait(sample);
+				total += sample.get();
+			}
+			float value = total / samples;
+			sum += value;
+			if (value > best) {
+				best = value;
+				bestMove = root.move;
+			}
+		}
+		// A partial iteration is worse than the last complete one
+		if (aborted) {
+			break;
+		}
+		result.move = bestMove;
+		result.score = best;
+		result.average = sum / moves.size();
+		result.depth = depth;
+		result.found = true;
+		if (Expired()) {
+			break;
+		}
+	}
+	result.nodes = nodes;
+	return result;
+}
+
+void Engine::Solver::Begin(const Board& board)
+{
+	search = pool.Async([this, board]() {
+		return Solve(board);
+	});
+}
@@ -0,0 +1,175 @@
+#include "SpriteBatch.h"
+#include "Profiler.h"
+
+#include <algorithm>
+
+
+Engine::SpriteBatch::SpriteBatch()
+{
+}
+
+
+Engine::SpriteBatch::~SpriteBatch()
+{
+	if (VAO != 0) {
+		glDeleteVertexArrays(1, &VAO);
+		glDeleteBuffers(1, &quadVBO);
+		glDeleteBuffers(1, &instanceVBO);
+	}
+}
+
+void Engine::SpriteBatch::Init()
+{
+	// Unit quad as a triangle strip, scaled and placed by the instance rect
+	GLfloat corners[] = {
+		0.0f, 0.0f, // Top Left
+		1.0f, 0.0f, // Top Right
+		0.0f, 1.0f, // Bottom Left
+		1.0f, 1.0f  // Bottom Right
+	};
+
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &quadVBO);
+	glGenBuffers(1, &instanceVBO);
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (GLvoid*)0);
+
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	for (GLuint i = 1; i <= 3; i++) {
+		glEnableVertexAttribArray(i);
+		glVertexAttribDivisor(i, 1);
+	}
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	Reserve(SPRITEBATCH_INITIAL_CAPACITY);
+}
+
+void Engine::SpriteBatch::Reserve(size_t count)
+{
+	capacity = count;
+	writeOffset = 0;
+	sprites.reserve(count);
+	instances.reserve(count);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(SpriteInstance) * capacity, NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Engine::SpriteBatch::Begin()
+{
+	sprites.clear();
+	drawCalls = 0;
+	spriteCount = 0;
+}
+
+void Engine::SpriteBatch::Draw(GLuint texture, vec2 position, vec2 size, vec4 uv, vec4 tint, int layer)
+{
+	sprites.push_back({ texture, layer, position, size, uv, tint });
+}
+
+void Engine::SpriteBatch::Submit(RenderQueue& queue, RenderPass pass, Shader* shader)
+{
+	runs.clear();
+	uploaded = false;
+	spriteCount = (unsigned int)sprites.size();
+	if (sprites.empty()) {
+		return;
+	}
+
+	// Lower layers first, then group by texture. Stable so equal keys keep submission order
+	stable_sort(sprites.begin(), sprites.end(), [](const Sprite& a, const Sprite& b) {
+		if (a.layer != b.layer) {
+			return a.layer < b.layer;
+		}
+		return a.texture < b.texture;
+	});
+
+	instances.clear();
+	for (const Sprite& s : sprites) {
+		instances.push_back({
+			s.position.x, s.position.y, s.size.x, s.size.y,
+			s.uv.x, s.uv.y, s.uv.z, s.uv.w,
+			(GLubyte)(glm::clamp(s.tint.x, 0.0f, 1.0f) * 255), (GLubyte)(glm::clamp(s.tint.y, 0.0f, 1.0f) * 255),
+			(GLubyte)(glm::clamp(s.tint.z, 0.0f, 1.0f) * 255), (GLubyte)(glm::clamp(s.tint.w, 0.0f, 1.0f) * 255)
+		});
+	}
+
+	size_t first = 0;
+	while (first < sprites.size()) {
+		size_t last = first + 1;
+		while (last < sprites.size() && sprites[last].texture == sprites[first].texture && sprites[last].layer == sprites[first].layer) {
+			last++;
+		}
+		Material material = { shader, sprites[first].texture, BlendMode::ALPHA };
+		queue.Submit(pass, sprites[first].layer, material, &SpriteBatch::DrawRun, this, (uint32_t)runs.size());
+		runs.push_back({ first, last - first });
+		first = last;
+	}
+}
+
+bool Engine::SpriteBatch::Upload(StateCache& state)
+{
+	if (instances.size() > capacity) {
+		size_t newCapacity = capacity;
+		while (newCapacity < instances.size()) {
+			newCapacity *= 2;
+		}
+		Reserve(newCapacity);
+		// Reserve binds the buffer without the cache
+		state.InvalidateBindings();
+	}
+
+	state.BindArrayBuffer(instanceVBO);
+	// Append after last frame's data, wrapping around by orphaning the whole buffer
+	// so the driver never has to wait for draws still reading the old range
+	GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+	if (writeOffset + instances.size() > capacity) {
+		writeOffset = 0;
+		access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+	}
+	void* dst = glMapBufferRange(GL_ARRAY_BUFFER, sizeof(SpriteInstance) * writeOffset, sizeof(SpriteInstance) * instances.size(), access);
+	if (dst == nullptr) {
+		// Out of memory or a lost context, the frame is not drawn and the next one orphans the buffer
+		writeOffset = capacity;
+		return false;
+	}
+	copy(instances.begin(), instances.end(), (SpriteInstance*)dst);
+	glUnmapBuffer(GL_ARRAY_BUFFER);
+	// The runs of this frame read from here, the next frame appends after them
+	drawOffset = writeOffset;
+	writeOffset += instances.size();
+	Profiler::Get().CountUpload(sizeof(SpriteInstance) * instances.size());
+	return true;
+}
+
+void Engine::SpriteBatch::DrawRun(void* owner, uint32_t run, StateCache& state)
+{
+	SpriteBatch* batch = (SpriteBatch*)owner;
+	if (!batch->uploaded) {
+		batch->uploadFailed = !batch->Upload(state);
+		batch->uploaded = true;
+	}
+	if (batch->uploadFailed) {
+		return;
+	}
+	const Run& r = batch->runs[run];
+	state.BindVertexArray(batch->VAO);
+	state.BindArrayBuffer(batch->instanceVBO);
+
+	// Point the instance attributes at this run instead of needing base instance support
+	size_t base = sizeof(SpriteInstance) * (batch->drawOffset + r.first);
+	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (GLvoid*)(base));
+	glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (GLvoid*)(base + 4 * sizeof(GLfloat)));
+	glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SpriteInstance), (GLvoid*)(base + 8 * sizeof(GLfloat)));
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)r.count);
+	batch->drawCalls++;
+
+	Profiler& profiler = Profiler::Get();
+	// Instance attributes
+	profiler.CountStateChange();
+	profiler.CountDrawCall();
+}
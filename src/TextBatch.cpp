@@ -0,0 +1,112 @@
+#include "TextBatch.h"
+#include "Profiler.h"
+
+
+Engine::TextBatch::TextBatch()
+{
+}
+
+
+Engine::TextBatch::~TextBatch()
+{
+	if (VAO != 0) {
+		glDeleteVertexArrays(1, &VAO);
+		glDeleteBuffers(1, &VBO);
+		glDeleteBuffers(1, &EBO);
+	}
+}
+
+void Engine::TextBatch::Init()
+{
+	vertices.reserve(TEXTBATCH_MAX_GLYPHS * 4);
+
+	// Every quad uses the same two triangles, so the index buffer never changes
+	vector<GLushort> indices(TEXTBATCH_MAX_GLYPHS * 6);
+	for (GLushort i = 0; i < TEXTBATCH_MAX_GLYPHS; i++) {
+		GLushort base = i * 4;
+		indices[i * 6 + 0] = base + 0;
+		indices[i * 6 + 1] = base + 1;
+		indices[i * 6 + 2] = base + 2;
+		indices[i * 6 + 3] = base + 2;
+		indices[i * 6 + 4] = base + 3;
+		indices[i * 6 + 5] = base + 0;
+	}
+
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &VBO);
+	glGenBuffers(1, &EBO);
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(TextVertex) * TEXTBATCH_MAX_GLYPHS * 4, NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort) * indices.size(), indices.data(), GL_STATIC_DRAW);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (GLvoid*)0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(TextVertex), (GLvoid*)(4 * sizeof(GLfloat)));
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Engine::TextBatch::Begin(const Font* font)
+{
+	this->font = font;
+	vertices.clear();
+}
+
+void Engine::TextBatch::AddText(const string& text, GLfloat x, GLfloat y, GLfloat scale, vec4 color)
+{
+	GLubyte r = (GLubyte)(clamp(color.x, 0.0f, 1.0f) * 255);
+	GLubyte g = (GLubyte)(clamp(color.y, 0.0f, 1.0f) * 255);
+	GLubyte b = (GLubyte)(clamp(color.z, 0.0f, 1.0f) * 255);
+	GLubyte a = (GLubyte)(clamp(color.w, 0.0f, 1.0f) * 255);
+	int capHeight = font->GetCapHeight();
+
+	for (string::const_iterator c = text.begin(); c != text.end(); c++)
+	{
+		const Glyph& ch = font->GetGlyph(*c);
+		GLfloat xpos = x + ch.Bearing.x * scale;
+		GLfloat ypos = y + (capHeight - ch.Bearing.y) * scale;
+		GLfloat w = ch.Size.x * scale;
+		GLfloat h = ch.Size.y * scale;
+
+		// Bottom Right, Top Right, Top Left, Bottom Left
+		vertices.push_back({ xpos + w, ypos + h, ch.UV.z, ch.UV.w, r, g, b, a });
+		vertices.push_back({ xpos + w, ypos, ch.UV.z, ch.UV.y, r, g, b, a });
+		vertices.push_back({ xpos, ypos, ch.UV.x, ch.UV.y, r, g, b, a });
+		vertices.push_back({ xpos, ypos + h, ch.UV.x, ch.UV.w, r, g, b, a });
+
+		x += ch.Advance * scale;
+	}
+}
+
+void Engine::TextBatch::Submit(RenderQueue& queue, RenderPass pass, int layer, Shader* shader)
+{
+	Material material = { shader, font->GetTexture(), BlendMode::ALPHA };
+	size_t chunks = (vertices.size() / 4 + TEXTBATCH_MAX_GLYPHS - 1) / TEXTBATCH_MAX_GLYPHS;
+	for (size_t chunk = 0; chunk < chunks; chunk++) {
+		queue.Submit(pass, layer, material, &TextBatch::DrawChunk, this, (uint32_t)chunk);
+	}
+}
+
+void Engine::TextBatch::DrawChunk(void* owner, uint32_t chunk, StateCache& state)
+{
+	TextBatch* batch = (TextBatch*)owner;
+	size_t first = (size_t)chunk * TEXTBATCH_MAX_GLYPHS * 4;
+	size_t count = batch->vertices.size() - first;
+	if (count > TEXTBATCH_MAX_GLYPHS * 4) {
+		count = TEXTBATCH_MAX_GLYPHS * 4;
+	}
+	state.BindVertexArray(batch->VAO);
+
+	// Orphan the previous storage so the driver does not wait for the last draw
+	state.BindArrayBuffer(batch->VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(TextVertex) * TEXTBATCH_MAX_GLYPHS * 4, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(TextVertex) * count, batch->vertices.data() + first);
+
+	glDrawElements(GL_TRIANGLES, (GLsizei)(count / 4 * 6), GL_UNSIGNED_SHORT, 0);
+
+	Profiler& profiler = Profiler::Get();
+	profiler.CountDrawCall();
+	profiler.CountUpload(sizeof(TextVertex) * count);
+}
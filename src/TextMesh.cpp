@@ -0,0 +1,207 @@
+#include "TextMesh.h"
+#include "Profiler.h"
+
+
+Engine::TextMesh::TextMesh()
+{
+}
+
+
+Engine::TextMesh::~TextMesh()
+{
+	if (VAO != 0) {
+		glDeleteVertexArrays(1, &VAO);
+		glDeleteBuffers(1, &VBO);
+		glDeleteBuffers(1, &EBO);
+	}
+}
+
+void Engine::TextMesh::Init()
+{
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &VBO);
+	glGenBuffers(1, &EBO);
+	// Same vertex layout as TextBatch, so both draw with the text shader
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (GLvoid*)0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(TextVertex), (GLvoid*)(4 * sizeof(GLfloat)));
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Engine::TextMesh::SetFont(const Font* font)
+{
+	if (font != this->font) {
+		this->font = font;
+		layoutDirty = true;
+	}
+}
+
+void Engine::TextMesh::SetText(const string& text)
+{
+	if (text != this->text) {
+		this->text = text;
+		layoutDirty = true;
+	}
+}
+
+void Engine::TextMesh::SetScale(float scale)
+{
+	if (scale != this->scale) {
+		this->scale = scale;
+		layoutDirty = true;
+	}
+}
+
+void Engine::TextMesh::SetColor(vec4 color)
+{
+	if (color != this->color) {
+		this->color = color;
+		verticesDirty = true;
+	}
+}
+
+void Engine::TextMesh::SetPosition(vec2 position)
+{
+	if (position != this->position) {
+		this->position = position;
+		verticesDirty = true;
+	}
+}
+
+void Engine::TextMesh::SetAlign(TextAlign align)
+{
+	if (align != this->align) {
+		this->align = align;
+		verticesDirty = true;
+	}
+}
+
+float Engine::TextMesh::Measure(const Font& font, const string& text, float scale)
+{
+	GLuint advance = 0;
+	for (char c : text) {
+		advance += font.GetGlyph(c).Advance;
+	}
+	return advance * scale;
+}
+
+vec2 Engine::TextMesh::GetSize()
+{
+	if (layoutDirty) {
+		Layout();
+	}
+	return size;
+}
+
+void Engine::TextMesh::Layout()
+{
+	PROFILE_SCOPE("TextMesh::Layout");
+	quads.clear();
+	size = vec2(0);
+	layoutDirty = false;
+	verticesDirty = true;
+	if (font == nullptr) {
+		return;
+	}
+
+	int capHeight = font->GetCapHeight();
+	float x = 0;
+	for (char c : text) {
+		const Glyph& ch = font->GetGlyph(c);
+		// Blank glyphs only move the pen
+		if (ch.Size.x > 0 && ch.Size.y > 0 && quads.size() < TEXTMESH_MAX_GLYPHS) {
+			float left = x + ch.Bearing.x * scale;
+			float top = (capHeight - ch.Bearing.y) * scale;
+			quads.push_back({ vec4(left, top, left + ch.Size.x * scale, top + ch.Size.y * scale), ch.UV });
+		}
+		x += ch.Advance * scale;
+	}
+	size = vec2(x, capHeight * scale);
+}
+
+void Engine::TextMesh::Build()
+{
+	if (layoutDirty) {
+		Layout();
+	}
+	verticesDirty = false;
+	uploadDirty = true;
+
+	vec2 origin = position;
+	if (align == TextAlign::CENTER) {
+		origin.x -= size.x / 2;
+	}
+	else if (align == TextAlign::RIGHT) {
+		origin.x -= size.x;
+	}
+	GLubyte r = (GLubyte)(clamp(color.x, 0.0f, 1.0f) * 255);
+	GLubyte g = (GLubyte)(clamp(color.y, 0.0f, 1.0f) * 255);
+	GLubyte b = (GLubyte)(clamp(color.z, 0.0f, 1.0f) * 255);
+	GLubyte a = (GLubyte)(clamp(color.w, 0.0f, 1.0f) * 255);
+
+	vertices.clear();
+	for (const Quad& quad : quads) {
+		float x0 = origin.x + quad.rect.x, y0 = origin.y + quad.rect.y;
+		float x1 = origin.x + quad.rect.z, y1 = origin.y + quad.rect.w;
+		// Bottom Right, Top Right, Top Left, Bottom Left
+		vertices.push_back({ x1, y1, quad.uv.z, quad.uv.w, r, g, b, a });
+		vertices.push_back({ x1, y0, quad.uv.z, quad.uv.y, r, g, b, a });
+		vertices.push_back({ x0, y0, quad.uv.x, quad.uv.y, r, g, b, a });
+		vertices.push_back({ x0, y1, quad.uv.x, quad.uv.w, r, g, b, a });
+	}
+}
+
+void Engine::TextMesh::Submit(RenderQueue& queue, RenderPass pass, int layer, Shader* shader)
+{
+	if (font == nullptr) {
+		return;
+	}
+	if (layoutDirty || verticesDirty) {
+		Build();
+	}
+	if (vertices.empty()) {
+		return;
+	}
+	Material material = { shader, font->GetTexture(), BlendMode::ALPHA };
+	queue.Submit(pass, layer, material, &TextMesh::Draw, this);
+}
+
+void Engine::TextMesh::Draw(void* owner, uint32_t argument, StateCache& state)
+{
+	TextMesh* mesh = (TextMesh*)owner;
+	size_t glyphs = mesh->vertices.size() / 4;
+	state.BindVertexArray(mesh->VAO);
+
+	if (mesh->uploadDirty) {
+		state.BindArrayBuffer(mesh->VBO);
+		if (glyphs > mesh->capacity) {
+			// Indices only change when the mesh outgrows them, the element buffer is part of the VAO
+			vector<GLushort> indices(glyphs * 6);
+			for (size_t i = 0; i < glyphs; i++) {
+				GLushort base = (GLushort)(i * 4);
+				indices[i * 6 + 0] = base + 0;
+				indices[i * 6 + 1] = base + 1;
+				indices[i * 6 + 2] = base + 2;
+				indices[i * 6 + 3] = base + 2;
+				indices[i * 6 + 4] = base + 3;
+				indices[i * 6 + 5] = base + 0;
+			}
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort) * indices.size(), indices.data(), GL_STATIC_DRAW);
+			glBufferData(GL_ARRAY_BUFFER, sizeof(TextVertex) * mesh->vertices.size(), mesh->vertices.data(), GL_STATIC_DRAW);
+			mesh->capacity = glyphs;
+		}
+		else {
+			glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(TextVertex) * mesh->vertices.size(), mesh->vertices.data());
+		}
+		mesh->uploadDirty = false;
+		Profiler::Get().CountUpload(sizeof(TextVertex) * mesh->vertices.size());
+	}
+
+	glDrawElements(GL_TRIANGLES, (GLsizei)(glyphs * 6), GL_UNSIGNED_SHORT, 0);
+	Profiler::Get().CountDrawCall();
+}
@@ -0,0 +1,116 @@
+#include "ThreadPool.h"
+
+
+// Which pool the current thread works for and its queue in that pool
+static thread_local const Engine::ThreadPool* currentPool = nullptr;
+static thread_local unsigned int currentQueue = 0;
+
+Engine::ThreadPool::ThreadPool(unsigned int workers) : pending(0)
+{
+	if (workers == 0) {
+		unsigned int cores = thread::hardware_concurrency();
+		workers = cores > 1 ? cores - 1 : 1;
+	}
+	for (unsigned int i = 0; i <= workers; i++) {
+		queues.push_back(make_unique<WorkerQueue>());
+	}
+	for (unsigned int i = 0; i < workers; i++) {
+		this->workers.push_back(thread(&ThreadPool::Run, this, i));
+	}
+}
+
+
+Engine::ThreadPool::~ThreadPool()
+{
+	{
+		lock_guard<mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	tasksAvailable.notify_all();
+	for (thread& worker : workers) {
+		worker.join();
+	}
+}
+
+Engine::ThreadPool& Engine::ThreadPool::GetDefault()
+{
+	static ThreadPool pool;
+	return pool;
+}
+
+unsigned int Engine::ThreadPool::GetQueueIndex() const
+{
+	return currentPool == this ? currentQueue : (unsigned int)queues.size() - 1;
+}
+
+void Engine::ThreadPool::Submit(function<void()> task)
+{
+	WorkerQueue& queue = *queues[GetQueueIndex()];
+	// Counted before it can be taken so pending never drops below zero
+	pending++;
+	{
+		lock_guard<mutex> lock(queue.lock);
+		queue.tasks.push_back(move(task));
+	}
+	// Taking the lock orders this with a worker checking pending before it sleeps
+	{
+		lock_guard<mutex> lock(sleepMutex);
+	}
+	tasksAvailable.notify_one();
+}
+
+bool Engine::ThreadPool::TakeTask(unsigned int index, function<void()>& task)
+{
+	if (pending == 0) {
+		return false;
+	}
+	unsigned int count = (unsigned int)queues.size();
+	// Own queue newest first while it is still warm in cache, everyone else's oldest first
+	for (unsigned int i = 0; i < count; i++) {
+		WorkerQueue& queue = *queues[(index + i) % count];
+		lock_guard<mutex> lock(queue.lock);
+		if (queue.tasks.empty()) {
+			continue;
+		}
+		if (i == 0 && index != count - 1) {
+			task = move(queue.tasks.back());
+			queue.tasks.pop_back();
+		}
+		else {
+			task = move(queue.tasks.front());
+			queue.tasks.pop_front();
+		}
+		pending--;
+		return true;
+	}
+	return false;
+}
+
+bool Engine::ThreadPool::RunPendingTask()
+{
+	function<void()> task;
+	if (!TakeTask(GetQueueIndex(), task)) {
+		return false;
+	}
+	task();
+	return true;
+}
+
+void Engine::ThreadPool::Run(unsigned int index)
+{
+	currentPool = this;
+	currentQueue = index;
+	while (true) {
+		function<void()> task;
+		if (TakeTask(index, task)) {
+			task();
+			continue;
+		}
+		unique_lock<mutex> lock(sleepMutex);
+		tasksAvailable.wait(lock, [this]() { return stopping || pending > 0; });
+		// Finish what is queued before stopping
+		if (stopping && pending == 0) {
+			return;
+		}
+	}
+}
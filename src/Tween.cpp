@@ -0,0 +1,196 @@
+#include "Tween.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+// Curves map 0..1 to 0..1, Back overshoots on the way
+static inline float EaseLinear(float t) { return t; }
+static inline float EaseQuadIn(float t) { return t * t; }
+static inline float EaseQuadOut(float t) { return t * (2 - t); }
+static inline float EaseQuadInOut(float t) { return t < 0.5f ? 2 * t * t : -1 + (4 - 2 * t) * t; }
+static inline float EaseCubicOut(float t) { float u = t - 1; return u * u * u + 1; }
+static inline float EaseBackOut(float t)
+{
+	const float s = 1.70158f;
+	float u = t - 1;
+	return u * u * ((s + 1) * u + s) + 1;
+}
+static inline float EaseBounceOut(float t)
+{
+	if (t < 1 / 2.75f) {
+		return 7.5625f * t * t;
+	}
+	if (t < 2 / 2.75f) {
+		t -= 1.5f / 2.75f;
+		return 7.5625f * t * t + 0.75f;
+	}
+	if (t < 2.5f / 2.75f) {
+		t -= 2.25f / 2.75f;
+		return 7.5625f * t * t + 0.9375f;
+	}
+	t -= 2.625f / 2.75f;
+	return 7.5625f * t * t + 0.984375f;
+}
+
+float Engine::TweenSystem::Ease(Easing easing, float t)
+{
+	switch (easing) {
+	case Easing::QUAD_IN: return EaseQuadIn(t);
+	case Easing::QUAD_OUT: return EaseQuadOut(t);
+	case Easing::QUAD_IN_OUT: return EaseQuadInOut(t);
+	case Easing::CUBIC_OUT: return EaseCubicOut(t);
+	case Easing::BACK_OUT: return EaseBackOut(t);
+	case Easing::BOUNCE_OUT: return EaseBounceOut(t);
+	default: return EaseLinear(t);
+	}
+}
+
+template<class T>
+TweenID Engine::TweenSystem::Insert(TweenGroups<T>& groups, T* target, T to, float duration, Easing easing, uint32_t tag, float delay)
+{
+	TweenArray<T>& tweens = groups.groups[(int)easing];
+	TweenID id = nextID++;
+	// Zero is INVALID_TWEEN
+	if (nextID == INVALID_TWEEN) {
+		nextID++;
+	}
+	tweens.targets.push_back(target);
+	tweens.from.push_back(*target);
+	tweens.delta.push_back(to - *target);
+	tweens.time.push_back(-delay);
+	// A zero duration finishes on the next Update
+	tweens.invDuration.push_back(1.0f / std::max(duration, 0.001f));
+	tweens.ids.push_back(id);
+	tweens.tags.push_back(tag);
+	return id;
+}
+
+TweenID Engine::TweenSystem::Add(float* target, float to, float duration, Easing easing, uint32_t tag, float delay)
+{
+	return Insert(floats, target, to, duration, easing, tag, delay);
+}
+
+TweenID Engine::TweenSystem::Add(vec2* target, vec2 to, float duration, Easing easing, uint32_t tag, float delay)
+{
+	return Insert(vec2s, target, to, duration, easing, tag, delay);
+}
+
+TweenID Engine::TweenSystem::Add(vec4* target, vec4 to, float duration, Easing easing, uint32_t tag, float delay)
+{
+	return Insert(vec4s, target, to, duration, easing, tag, delay);
+}
+
+template<class T>
+void Engine::TweenSystem::Remove(TweenArray<T>& tweens, size_t index)
+{
+	// Order does not matter, the last tween takes the slot
+	size_t last = tweens.ids.size() - 1;
+	tweens.targets[index] = tweens.targets[last];
+	tweens.from[index] = tweens.from[last];
+	tweens.delta[index] = tweens.delta[last];
+	tweens.time[index] = tweens.time[last];
+	tweens.invDuration[index] = tweens.invDuration[last];
+	tweens.ids[index] = tweens.ids[last];
+	tweens.tags[index] = tweens.tags[last];
+	tweens.targets.pop_back();
+	tweens.from.pop_back();
+	tweens.delta.pop_back();
+	tweens.time.pop_back();
+	tweens.invDuration.pop_back();
+	tweens.ids.pop_back();
+	tweens.tags.pop_back();
+}
+
+template<class T, class F>
+void Engine::TweenSystem::Advance(TweenArray<T>& tweens, float deltaTime, F ease)
+{
+	size_t i = 0;
+	while (i < tweens.ids.size()) {
+		tweens.time[i] += deltaTime;
+		float t = tweens.time[i] * tweens.invDuration[i];
+		if (t < 0) {
+			// Still waiting for its delay
+			i++;
+			continue;
+		}
+		if (t >= 1) {
+			// Exactly the end value, whatever rounding the curve does
+			*tweens.targets[i] = tweens.from[i] + tweens.delta[i];
+			completed.push_back({ tweens.ids[i], tweens.tags[i] });
+			// The swapped in tween has not been advanced yet, so i stays
+			Remove(tweens, i);
+			continue;
+		}
+		*tweens.targets[i] = tweens.from[i] + tweens.delta[i] * ease(t);
+		i++;
+	}
+}
+
+template<class T>
+void Engine::TweenSystem::Advance(TweenGroups<T>& groups, float deltaTime)
+{
+	// The curve is picked once per group, each loop gets its own inlined copy
+	Advance(groups.groups[(int)Easing::LINEAR], deltaTime, EaseLinear);
+	Advance(groups.groups[(int)Easing::QUAD_IN], deltaTime, EaseQuadIn);
+	Advance(groups.groups[(int)Easing::QUAD_OUT], deltaTime, EaseQuadOut);
+	Advance(groups.groups[(int)Easing::QUAD_IN_OUT], deltaTime, EaseQuadInOut);
+	Advance(groups.groups[(int)Easing::CUBIC_OUT], deltaTime, EaseCubicOut);
+	Advance(groups.groups[(int)Easing::BACK_OUT], deltaTime, EaseBackOut);
+	Advance(groups.groups[(int)Easing::BOUNCE_OUT], deltaTime, EaseBounceOut);
+}
+
+void Engine::TweenSystem::Update(float deltaTime)
+{
+	completed.clear();
+	Advance(floats, deltaTime);
+	Advance(vec2s, deltaTime);
+	Advance(vec4s, deltaTime);
+}
+
+void Engine::TweenSystem::Cancel(const void* target)
+{
+	auto cancel = [target](auto& groups) {
+		for (auto& tweens : groups.groups) {
+			size_t i = 0;
+			while (i < tweens.ids.size()) {
+				if (tweens.targets[i] == target) {
+					Remove(tweens, i);
+				}
+				else {
+					i++;
+				}
+			}
+		}
+	};
+	cancel(floats);
+	cancel(vec2s);
+	cancel(vec4s);
+}
+
+void Engine::TweenSystem::Clear()
+{
+	auto clear = [](auto& groups) {
+		for (auto& tweens : groups.groups) {
+			tweens = {};
+		}
+	};
+	clear(floats);
+	clear(vec2s);
+	clear(vec4s);
+	completed.clear();
+}
+
+size_t Engine::TweenSystem::GetCount() const
+{
+	size_t count = 0;
+	auto add = [&count](const auto& groups) {
+		for (const auto& tweens : groups.groups) {
+			count += tweens.ids.size();
+		}
+	};
+	add(floats);
+	add(vec2s);
+	add(vec4s);
+	return count;
+}
@@ -0,0 +1,94 @@
+// Plays games with the Solver choosing every swap. Used as a soak test for the
+// board code and to estimate how hard a board size and colour count are.
+//
+// Usage: AutoPlay [games] [moves] [budget ms] [colours] [depth]
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+
+#include "Board.h"
+#include "Cascade.h"
+#include "Moves.h"
+#include "Solver.h"
+
+using namespace std;
+
+#define AUTOPLAY_DEFAULT_GAMES 20
+#define AUTOPLAY_DEFAULT_MOVES 30
+
+int main(int argc, char** argv)
+{
+	int games = argc > 1 ? atoi(argv[1]) : AUTOPLAY_DEFAULT_GAMES;
+	int moves = argc > 2 ? atoi(argv[2]) : AUTOPLAY_DEFAULT_MOVES;
+	double budget = argc > 3 ? atof(argv[3]) : SOLVER_DEFAULT_BUDGET;
+	int colours = argc > 4 ? atoi(argv[4]) : BOARD_DEFAULT_COLOURS;
+	int depth = argc > 5 ? atoi(argv[5]) : SOLVER_DEFAULT_DEPTH;
+	if (games < 1 || moves < 1 || budget < 0 || colours < 3 || colours > BOARD_MAX_COLOURS || depth < 1) {
+		cerr << "Usage: " << argv[0] << " [games] [moves] [budget ms] [colours 3-" << BOARD_MAX_COLOURS << "] [depth]" << endl;
+		return 1;
+	}
+
+	Engine::Solver solver;
+	solver.SetBudget(budget);
+	solver.SetDepth(depth);
+	Engine::CascadeResolver resolver;
+	Engine::Random random(1234);
+	Engine::Board board(BOARD_DEFAULT_WIDTH, BOARD_DEFAULT_HEIGHT, colours);
+	Engine::MatchMask matches;
+
+	unsigned long long cleared = 0, nodes = 0, decisions = 0, deadlocks = 0, depthSum = 0;
+	double average = 0, slowest = 0, thinking = 0;
+	for (int game = 0; game < games; game++) {
+		for (int y = 0; y < board.GetHeight(); y++) {
+			for (int x = 0; x < board.GetWidth(); x++) {
+				board.Set(x, y, (uint8_t)random.NextInt(colours));
+			}
+		}
+		resolver.ResolveAll(board, random);
+		for (int m = 0; m < moves; m++) {
+			auto start = chrono::steady_clock::now();
+			Engine::SolverResult result = solver.Solve(board);
+			double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+			thinking += ms;
+			slowest = ms > slowest ? ms : slowest;
+			if (!result.found) {
+				// What the game does on a deadlock: start over with a fresh board
+				deadlocks++;
+				for (int y = 0; y < board.GetHeight(); y++) {
+					for (int x = 0; x < board.GetWidth(); x++) {
+						board.Set(x, y, (uint8_t)random.NextInt(colours));
+					}
+				}
+				resolver.ResolveAll(board, random);
+				continue;
+			}
+			const Engine::Move& move = result.move;
+			int x2 = move.vertical ? move.x : move.x + 1;
+			int y2 = move.vertical ? move.y + 1 : move.y;
+			board.Swap(move.x, move.y, x2, y2);
+			resolver.ResolveSwap(board, random, move.x, move.y, x2, y2);
+			if (resolver.GetClearedCount() == 0 || board.FindMatches(matches)) {
+				cerr << "Solver played an illegal move or the board did not settle" << endl;
+				return 1;
+			}
+			cleared += resolver.GetClearedCount();
+			nodes += result.nodes;
+			depthSum += result.depth;
+			average += result.average;
+			decisions++;
+		}
+	}
+
+	cout << games << " games of " << moves << " moves, " << colours << " colours, " << budget << " ms budget" << endl;
+	if (decisions == 0) {
+		cout << "every board was deadlocked" << endl;
+		return 0;
+	}
+	cout << "cleared per move: " << (double)cleared / decisions << ", deadlocks: " << deadlocks << endl;
+	// Lower means fewer good moves to find, a rough difficulty for the level
+	cout << "mean move value: " << average / decisions << endl;
+	cout << "decision: " << thinking / (decisions + deadlocks) << " ms mean, " << slowest << " ms max, depth "
+		<< (double)depthSum / decisions << ", " << (double)nodes / decisions << " nodes" << endl;
+	return 0;
+}
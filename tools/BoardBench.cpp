@@ -0,0 +1,316 @@
+// Times Board match detection against a plain 2D array scanner and move
+// generation against trying every swap, checking that the results agree.
+// Cascades resolved from the changed area are checked against full rescans
+// after every legal swap. Also times the board generator against rerolling
+// random boards. Exits with 1 on any mismatch.
+//
+// Usage: BoardBench [width] [height] [colours] [iterations]
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+
+#include "Board.h"
+#include "Cascade.h"
+#include "Moves.h"
+#include "Generator.h"
+
+using namespace std;
+
+#define BENCH_BOARDS 256
+#define BENCH_DEFAULT_ITERATIONS 20000
+#define BENCH_MAX_REROLLS 2000000
+// ResolveAll calls per board before settling is given up on
+#define BENCH_MAX_SETTLES 1000
+
+// What the game did before bitboards: walk every cell and count equal neighbours
+static bool FindMatchesNaive(const Engine::Board& board, Engine::MatchMask& matches)
+{
+	int width = board.GetWidth(), height = board.GetHeight();
+	bool any = false;
+	matches.Clear();
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x + 2 < width; x++) {
+			uint8_t colour = board.Get(x, y);
+			if (colour != BOARD_EMPTY && board.Get(x + 1, y) == colour && board.Get(x + 2, y) == colour) {
+				matches.rows[y] |= 7ULL << x;
+				any = true;
+			}
+		}
+	}
+	for (int y = 0; y + 2 < height; y++) {
+		for (int x = 0; x < width; x++) {
+			uint8_t colour = board.Get(x, y);
+			if (colour != BOARD_EMPTY && board.Get(x, y + 1) == colour && board.Get(x, y + 2) == colour) {
+				matches.rows[y] |= 1ULL << x;
+				matches.rows[y + 1] |= 1ULL << x;
+				matches.rows[y + 2] |= 1ULL << x;
+				any = true;
+			}
+		}
+	}
+	return any;
+}
+
+// Swap, rescan, swap back for every pair of neighbours
+static unsigned int CountMovesNaive(const Engine::Board& board)
+{
+	Engine::Board copy = board;
+	Engine::MatchMask matches;
+	unsigned int count = 0;
+	for (int y = 0; y < board.GetHeight(); y++) {
+		for (int x = 0; x < board.GetWidth(); x++) {
+			if (x + 1 < board.GetWidth()) {
+				copy.Swap(x, y, x + 1, y);
+				count += copy.FindMatches(matches);
+				copy.Swap(x, y, x + 1, y);
+			}
+			if (y + 1 < board.GetHeight()) {
+				copy.Swap(x, y, x, y + 1);
+				count += copy.FindMatches(matches);
+				copy.Swap(x, y, x, y + 1);
+			}
+		}
+	}
+	return count;
+}
+
+// Every legal swap found by trying them all
+static void GenerateMovesNaive(const Engine::Board& board, Engine::MoveMask& moves)
+{
+	Engine::Board copy = board;
+	Engine::MatchMask matches;
+	for (int y = 0; y < board.GetHeight(); y++) {
+		moves.horizontal[y] = moves.vertical[y] = 0;
+		for (int x = 0; x < board.GetWidth(); x++) {
+			if (x + 1 < board.GetWidth()) {
+				copy.Swap(x, y, x + 1, y);
+				moves.horizontal[y] |= (uint64_t)copy.FindMatches(matches) << x;
+				copy.Swap(x, y, x + 1, y);
+			}
+			if (y + 1 < board.GetHeight()) {
+				copy.Swap(x, y, x, y + 1);
+				moves.vertical[y] |= (uint64_t)copy.FindMatches(matches) << x;
+				copy.Swap(x, y, x, y + 1);
+			}
+		}
+	}
+}
+
+// Cascade with a full rescan per step. Columns are refilled in the same order
+// as CascadeResolver, so with the same seed both must end on the same board.
+static int ResolveNaive(Engine::Board& board, Engine::Random& random, unsigned int& cleared)
+{
+	Engine::MatchMask matches;
+	int step = 0;
+	cleared = 0;
+	while (step < CASCADE_MAX_STEPS && FindMatchesNaive(board, matches)) {
+		for (int x = 0; x < board.GetWidth(); x++) {
+			// Survivors drop to the bottom, what is left above them is refilled
+			int write = board.GetHeight() - 1;
+			for (int y = board.GetHeight() - 1; y >= 0; y--) {
+				if (matches.Test(x, y)) {
+					cleared++;
+				}
+				else {
+					board.Set(x, write--, board.Get(x, y));
+				}
+			}
+			for (int y = write; y >= 0; y--) {
+				board.Set(x, y, (uint8_t)random.NextInt(board.GetColourCount()));
+			}
+		}
+		step++;
+	}
+	return step;
+}
+
+static bool SameBoard(const Engine::Board& a, const Engine::Board& b)
+{
+	for (int y = 0; y < a.GetHeight(); y++) {
+		for (int x = 0; x < a.GetWidth(); x++) {
+			if (a.Get(x, y) != b.Get(x, y)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+template <typename F>
+static double Time(const char* name, const vector<Engine::Board>& boards, int iterations, F find)
+{
+	Engine::MatchMask matches;
+	unsigned long long found = 0;
+	auto start = chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		const Engine::Board& board = boards[i % boards.size()];
+		found += find(board, matches);
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	double ns = seconds * 1e9 / iterations;
+	cout << name << ": " << ns << " ns/board (" << found << " found)" << endl;
+	return ns;
+}
+
+int main(int argc, char** argv)
+{
+	int width = argc > 1 ? atoi(argv[1]) : BOARD_DEFAULT_WIDTH;
+	int height = argc > 2 ? atoi(argv[2]) : BOARD_DEFAULT_HEIGHT;
+	int colours = argc > 3 ? atoi(argv[3]) : BOARD_DEFAULT_COLOURS;
+	int iterations = argc > 4 ? atoi(argv[4]) : BENCH_DEFAULT_ITERATIONS;
+	if (width < 3 || width > BOARD_MAX_WIDTH || height < 3 || height > BOARD_MAX_HEIGHT || colours < 2 || colours > BOARD_MAX_COLOURS || iterations < 1) {
+		cerr << "Usage: " << argv[0] << " [width 3-" << BOARD_MAX_WIDTH << "] [height 3-" << BOARD_MAX_HEIGHT
+			<< "] [colours 2-" << BOARD_MAX_COLOURS << "] [iterations]" << endl;
+		return 1;
+	}
+
+	mt19937 rng(1234);
+	uniform_int_distribution<int> colour(0, colours - 1);
+	vector<Engine::Board> boards(BENCH_BOARDS, Engine::Board(width, height, colours));
+	for (Engine::Board& board : boards) {
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				board.Set(x, y, (uint8_t)colour(rng));
+			}
+		}
+	}
+
+	// All three must agree before the timings mean anything
+	for (const Engine::Board& board : boards) {
+		Engine::MatchMask naive, scalar, simd;
+		FindMatchesNaive(board, naive);
+		board.FindMatchesScalar(scalar);
+		board.FindMatches(simd);
+		for (int y = 0; y < height; y++) {
+			if (naive.rows[y] != scalar.rows[y] || naive.rows[y] != simd.rows[y]) {
+				cerr << "Mismatch in row " << y << endl;
+				return 1;
+			}
+		}
+	}
+
+	cout << width << "x" << height << ", " << colours << " colours, " << iterations << " iterations" << endl;
+	double naive = Time("naive", boards, iterations, FindMatchesNaive);
+	double scalar = Time("bitboard", boards, iterations, [](const Engine::Board& board, Engine::MatchMask& matches) {
+		return board.FindMatchesScalar(matches);
+	});
+	double simd = Time("bitboard simd", boards, iterations, [](const Engine::Board& board, Engine::MatchMask& matches) {
+		return board.FindMatches(matches);
+	});
+	cout << "speedup: " << naive / scalar << "x scalar, " << naive / simd << "x simd" << endl;
+
+	// Move generation expects settled boards
+	Engine::CascadeResolver resolver;
+	Engine::Random random(1234);
+	Engine::MatchMask matches;
+	for (Engine::Board& board : boards) {
+		// With few colours on a large board the refills can keep matching
+		int settles = 0;
+		while (board.FindMatches(matches)) {
+			if (++settles > BENCH_MAX_SETTLES) {
+				cerr << "Board does not settle, use more colours" << endl;
+				return 1;
+			}
+			resolver.ResolveAll(board, random);
+		}
+		if (Engine::MoveGenerator::Count(board) != CountMovesNaive(board)) {
+			cerr << "Move count mismatch" << endl;
+			return 1;
+		}
+	}
+
+	// The exact swaps, then every one of them played out both ways
+	unsigned long long cascades = 0;
+	for (size_t i = 0; i < boards.size(); i++) {
+		const Engine::Board& board = boards[i];
+		Engine::MoveMask generated, naiveMask;
+		bool any = Engine::MoveGenerator::Generate(board, generated);
+		GenerateMovesNaive(board, naiveMask);
+		bool naiveAny = false;
+		for (int y = 0; y < height; y++) {
+			if (generated.horizontal[y] != naiveMask.horizontal[y] || generated.vertical[y] != naiveMask.vertical[y]) {
+				cerr << "Move mismatch in row " << y << " of board " << i << endl;
+				return 1;
+			}
+			naiveAny = naiveAny || naiveMask.horizontal[y] || naiveMask.vertical[y];
+		}
+		if (any != naiveAny) {
+			cerr << "Move generator result mismatch on board " << i << endl;
+			return 1;
+		}
+
+		vector<Engine::Move> legal;
+		Engine::MoveGenerator::List(board, legal);
+		for (const Engine::Move& move : legal) {
+			int x2 = move.vertical ? move.x : move.x + 1;
+			int y2 = move.vertical ? move.y + 1 : move.y;
+			uint64_t seed = ++cascades;
+			Engine::Board incremental = board, rescanned = board;
+			Engine::Random incrementalRandom(seed), rescannedRandom(seed);
+			incremental.Swap(move.x, move.y, x2, y2);
+			rescanned.Swap(move.x, move.y, x2, y2);
+			int steps = resolver.ResolveSwap(incremental, incrementalRandom, move.x, move.y, x2, y2);
+			unsigned int cleared;
+			int naiveSteps = ResolveNaive(rescanned, rescannedRandom, cleared);
+			if (steps != naiveSteps || resolver.GetClearedCount() != cleared || !SameBoard(incremental, rescanned)) {
+				cerr << "Cascade mismatch on board " << i << " after swapping (" << (int)move.x << ", " << (int)move.y
+					<< ") with (" << x2 << ", " << y2 << ")" << endl;
+				return 1;
+			}
+		}
+	}
+	cout << cascades << " cascades match full rescans" << endl;
+	int moveIterations = iterations / 10 > 0 ? iterations / 10 : 1;
+	double naiveMoves = Time("moves naive", boards, moveIterations, [](const Engine::Board& board, Engine::MatchMask&) {
+		return CountMovesNaive(board) > 0;
+	});
+	double moves = Time("moves", boards, moveIterations, [](const Engine::Board& board, Engine::MatchMask&) {
+		return Engine::MoveGenerator::Count(board) > 0;
+	});
+	cout << "speedup: " << naiveMoves / moves << "x moves" << endl;
+
+	// Starting boards: reroll the whole board until it is clean and playable, against the generator
+	int boardIterations = iterations / 10 > 0 ? iterations / 10 : 1;
+	Engine::Board generated(width, height, colours);
+	for (int i = 0; i < boardIterations; i++) {
+		if (!Engine::BoardGenerator::Generate(generated, (uint64_t)i)) {
+			cerr << "Generator failed" << endl;
+			return 1;
+		}
+		if (generated.FindMatches(matches) || !Engine::MoveGenerator::HasMove(generated)) {
+			cerr << "Generated board has a match or no move" << endl;
+			return 1;
+		}
+	}
+	auto start = chrono::steady_clock::now();
+	unsigned long long rerolls = 0;
+	int rerolled = 0;
+	// Large boards almost never come out clean, so rerolling has to give up at some point
+	for (; rerolled < boardIterations && rerolls < BENCH_MAX_REROLLS; rerolled++) {
+		do {
+			for (int y = 0; y < height; y++) {
+				for (int x = 0; x < width; x++) {
+					generated.Set(x, y, (uint8_t)random.NextInt(colours));
+				}
+			}
+			rerolls++;
+		} while ((generated.FindMatches(matches) || !Engine::MoveGenerator::HasMove(generated)) && rerolls < BENCH_MAX_REROLLS);
+	}
+	double naiveBoards = rerolled / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	start = chrono::steady_clock::now();
+	for (int i = 0; i < boardIterations; i++) {
+		Engine::BoardGenerator::Generate(generated, random);
+	}
+	double generatedBoards = boardIterations / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	cout << "boards generator: " << generatedBoards << " boards/s" << endl;
+	if (rerolls >= BENCH_MAX_REROLLS) {
+		cout << "boards reroll: gave up after " << rerolls << " tries" << endl;
+		return 0;
+	}
+	cout << "boards reroll: " << naiveBoards << " boards/s (" << (double)rerolls / rerolled << " tries each)" << endl;
+	cout << "speedup: " << generatedBoards / naiveBoards << "x boards" << endl;
+	return 0;
+}
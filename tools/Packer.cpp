@@ -0,0 +1,202 @@
+// Bakes the media directory into one archive the game memory maps at startup.
+// Images are stored decoded as RGBA, fonts as pre-rasterised glyph atlases
+// (one per requested pixel size) plus a distance field atlas, shaders and
+// audio as they are.
+//
+// Usage: Packer <media directory> <output archive> [font pixel sizes...]
+// Run it from the build after the media files change, the game looks for
+// ARCHIVE_NAME next to its loose files and falls back to them without it.
+
+#include <SOIL/SOIL.h>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <filesystem>
+
+#include "Archive.h"
+#include "Font.h"
+
+using namespace std;
+
+#define DEFAULT_FONT_SIZE 40
+
+struct PackedEntry {
+	Engine::ArchiveEntry entry;
+	vector<unsigned char> data;
+};
+
+static bool ReadFile(const filesystem::path& path, vector<unsigned char>& data)
+{
+	ifstream file(path, ios::binary);
+	if (!file) {
+		return false;
+	}
+	data.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+	return true;
+}
+
+static PackedEntry MakeEntry(const string& name, Engine::ArchiveEntryType type)
+{
+	PackedEntry packed = {};
+	strncpy(packed.entry.name, name.c_str(), ARCHIVE_NAME_LENGTH - 1);
+	packed.entry.type = type;
+	return packed;
+}
+
+static bool PackImage(const filesystem::path& path, const string& name, vector<PackedEntry>& entries)
+{
+	int width, height;
+	unsigned char* pixels = SOIL_load_image(path.string().c_str(), &width, &height, 0, SOIL_LOAD_RGBA);
+	if (pixels == nullptr) {
+		cout << "Unable to decode " << path << ": " << SOIL_last_result() << endl;
+		return false;
+	}
+	PackedEntry packed = MakeEntry(name, Engine::ArchiveEntryType::IMAGE_RGBA);
+	packed.entry.width = width;
+	packed.entry.height = height;
+	packed.data.assign(pixels, pixels + (size_t)width * height * 4);
+	SOIL_free_image_data(pixels);
+	entries.push_back(move(packed));
+	return true;
+}
+
+static bool PackFont(const filesystem::path& path, const string& name, unsigned int pixelSize, vector<PackedEntry>& entries)
+{
+	Engine::FontBitmap bitmap;
+	string error;
+	if (!Engine::Font::Rasterize(path.string().c_str(), pixelSize, bitmap, error)) {
+		cout << error << endl;
+		return false;
+	}
+	PackedEntry packed = MakeEntry(Engine::Archive::FontEntryName(name, pixelSize), Engine::ArchiveEntryType::FONT_ATLAS);
+	packed.entry.width = bitmap.width;
+	packed.entry.height = bitmap.height;
+	packed.entry.param = pixelSize;
+	packed.data.resize(sizeof(Engine::ArchiveGlyph) * FONT_NUM_GLYPHS);
+	Engine::ArchiveGlyph* glyphs = (Engine::ArchiveGlyph*)packed.data.data();
+	for (int c = 0; c < FONT_NUM_GLYPHS; c++) {
+		const Engine::Glyph& glyph = bitmap.glyphs[c];
+		glyphs[c] = { glyph.Size.x, glyph.Size.y, glyph.Bearing.x, glyph.Bearing.y, glyph.Advance,
+			{ glyph.UV.x, glyph.UV.y, glyph.UV.z, glyph.UV.w } };
+	}
+	packed.data.insert(packed.data.end(), bitmap.pixels.begin(), bitmap.pixels.end());
+	entries.push_back(move(packed));
+	return true;
+}
+
+static bool PackSDFFont(const filesystem::path& path, const string& name, vector<PackedEntry>& entries)
+{
+	vector<unsigned char> font;
+	Engine::FontBitmap bitmap;
+	string error;
+	if (!ReadFile(path, font) || !Engine::Font::RasterizeSDF(path.string().c_str(), FONT_SDF_SIZE, FONT_SDF_SPREAD, bitmap, error)) {
+		cout << error << endl;
+		return false;
+	}
+	PackedEntry packed = MakeEntry(Engine::Archive::SDFFontEntryName(name), Engine::ArchiveEntryType::FONT_SDF);
+	packed.entry.width = bitmap.width;
+	packed.entry.height = bitmap.height;
+	packed.entry.param = FONT_SDF_SIZE;
+	// Same bytes as a font cache file, read back by Font::ReadSDF
+	Engine::Font::WriteSDF(bitmap, Engine::Font::MakeSDFKey(font.data(), font.size()), packed.data);
+	entries.push_back(move(packed));
+	return true;
+}
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		cout << "Usage: Packer <media directory> <output archive> [font pixel sizes...]" << endl;
+		return 1;
+	}
+	filesystem::path mediaPath = argv[1];
+	vector<unsigned int> fontSizes;
+	for (int i = 3; i < argc; i++) {
+		fontSizes.push_back((unsigned int)atoi(argv[i]));
+	}
+	if (fontSizes.empty()) {
+		fontSizes.push_back(DEFAULT_FONT_SIZE);
+	}
+
+	// Sorted so the same media always gives the same archive
+	vector<filesystem::path> files;
+	for (const filesystem::directory_entry& file : filesystem::directory_iterator(mediaPath)) {
+		if (file.is_regular_file()) {
+			files.push_back(file.path());
+		}
+	}
+	sort(files.begin(), files.end());
+
+	vector<PackedEntry> entries;
+	for (const filesystem::path& path : files) {
+		string name = path.filename().string();
+		string extension = path.extension().string();
+		if (name.size() >= ARCHIVE_NAME_LENGTH) {
+			cout << "Skipping " << name << ", name too long" << endl;
+			continue;
+		}
+		bool ok = true;
+		if (extension == ".png" || extension == ".jpg" || extension == ".bmp" || extension == ".tga") {
+			ok = PackImage(path, name, entries);
+		}
+		else if (extension == ".ttf" || extension == ".otf") {
+			for (unsigned int size : fontSizes) {
+				ok = ok && PackFont(path, name, size, entries);
+			}
+			ok = ok && PackSDFFont(path, name, entries);
+		}
+		else if (extension == ".vert" || extension == ".frag" || extension == ".geom") {
+			PackedEntry packed = MakeEntry(name, Engine::ArchiveEntryType::SHADER);
+			ok = ReadFile(path, packed.data);
+			entries.push_back(move(packed));
+		}
+		else if (extension == ".ogg" || extension == ".wav" || extension == ".mp3" || extension == ".flac") {
+			PackedEntry packed = MakeEntry(name, Engine::ArchiveEntryType::AUDIO);
+			ok = ReadFile(path, packed.data);
+			entries.push_back(move(packed));
+		}
+		else {
+			continue;
+		}
+		if (!ok) {
+			cout << "Failed to pack " << path << endl;
+			return 1;
+		}
+	}
+
+	// Header, aligned blobs, then the index
+	ofstream out(argv[2], ios::binary | ios::trunc);
+	if (!out) {
+		cout << "Unable to write " << argv[2] << endl;
+		return 1;
+	}
+	Engine::ArchiveHeader header = { ARCHIVE_MAGIC, ARCHIVE_VERSION, (uint32_t)entries.size(), 0, 0 };
+	out.write((const char*)&header, sizeof(header));
+	uint64_t offset = sizeof(header);
+	const char padding[ARCHIVE_ALIGNMENT] = {};
+	for (PackedEntry& packed : entries) {
+		uint64_t aligned = (offset + ARCHIVE_ALIGNMENT - 1) / ARCHIVE_ALIGNMENT * ARCHIVE_ALIGNMENT;
+		out.write(padding, aligned - offset);
+		packed.entry.offset = aligned;
+		packed.entry.size = packed.data.size();
+		out.write((const char*)packed.data.data(), packed.data.size());
+		offset = aligned + packed.data.size();
+	}
+	uint64_t aligned = (offset + ARCHIVE_ALIGNMENT - 1) / ARCHIVE_ALIGNMENT * ARCHIVE_ALIGNMENT;
+	out.write(padding, aligned - offset);
+	header.indexOffset = aligned;
+	for (const PackedEntry& packed : entries) {
+		out.write((const char*)&packed.entry, sizeof(packed.entry));
+	}
+	out.seekp(0);
+	out.write((const char*)&header, sizeof(header));
+	if (!out) {
+		cout << "Unable to write " << argv[2] << endl;
+		return 1;
+	}
+
+	cout << "Packed " << entries.size() << " entries into " << argv[2] << endl;
+	return 0;
+}
@@ -0,0 +1,133 @@
+// Keeps a particle system filled with match bursts and renders it offscreen,
+// reporting the frame cost against the 60 FPS budget. Like RenderBench it runs
+// on Mesa llvmpipe through EGL surfaceless (or OSMesa).
+// Needs src/Offscreen.cpp and src/OffscreenRunner.cpp on top of the engine.
+// With --pipelined the simulation runs a frame ahead on a worker and the GL
+// thread draws a copy of the previous frame's particles.
+//
+// Usage: ParticleBench [--pipelined] [particles] [frames] [width] [height] [image.ppm]
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "Game.h"
+#include "Particles.h"
+
+using namespace std;
+
+#define PARTICLEBENCH_DEFAULT_PARTICLES 100000
+#define PARTICLEBENCH_DEFAULT_FRAMES 600
+#define PARTICLEBENCH_DELTA (1000.0f / 60.0f)
+#define PARTICLEBENCH_BUDGET (1000.0f / 60.0f)
+#define PARTICLEBENCH_BURST 256
+
+class ParticleGame :
+	public Engine::Game
+{
+public:
+	ParticleGame(size_t target, bool pipelined) :
+		particles(target + PARTICLEBENCH_BURST),
+		snapshots{ Engine::ParticleSystem(target + PARTICLEBENCH_BURST), Engine::ParticleSystem(target + PARTICLEBENCH_BURST) },
+		target(target)
+	{
+		SetPipelined(pipelined);
+	}
+
+protected:
+	virtual void Init()
+	{
+		shader = BuildShader("particle.vert", "particle.frag");
+		particles.Init();
+		snapshots[0].Init();
+		snapshots[1].Init();
+		particles.SetGravity(vec2(0, 400));
+		particles.SetDrag(0.5f);
+		SetProjection(ortho(0.0f, (float)GetScreenWidth(), (float)GetScreenHeight(), 0.0f, -1.0f, 1.0f));
+	}
+	virtual void DeInit() {}
+	virtual void Update(float deltaTime)
+	{
+		particles.Update(deltaTime, &Engine::ThreadPool::GetDefault());
+		// Tops the pool up with bursts in random places, the way cleared tiles would
+		Engine::ParticleBurst burst = { 50, 300, 500, 1500, 12, 2, 0, 6.2831853f, vec4(0.4f, 1.0f, 0.3f, 0.8f) };
+		while (particles.GetCount() < target) {
+			vec2 position(GetRandom().NextFloat() * GetScreenWidth(), GetRandom().NextFloat() * GetScreenHeight());
+			burst.color.r = GetRandom().NextFloat();
+			particles.Emit(burst, position, PARTICLEBENCH_BURST);
+		}
+	}
+	virtual void Render()
+	{
+		Draw(particles);
+	}
+	virtual void PrepareRender(unsigned int buffer)
+	{
+		snapshots[buffer].CopyDrawState(particles);
+	}
+	virtual void RenderPrepared(unsigned int buffer)
+	{
+		Draw(snapshots[buffer]);
+	}
+
+private:
+	void Draw(Engine::ParticleSystem& system)
+	{
+		glViewport(0, 0, GetScreenWidth(), GetScreenHeight());
+		GetStateCache().SetClearColor(vec4(0.0f, 0.0f, 0.0f, 1.0f));
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		system.Submit(GetRenderQueue(), Engine::RENDER_PASS_EFFECTS, 0, shader);
+	}
+	Engine::ParticleSystem particles;
+	// Drawn in pipelined mode while particles runs the next frame
+	Engine::ParticleSystem snapshots[2];
+	Engine::Shader* shader = nullptr;
+	size_t target;
+};
+
+int main(int argc, char** argv)
+{
+	bool pipelined = argc > 1 && strcmp(argv[1], "--pipelined") == 0;
+	if (pipelined) {
+		argv++;
+		argc--;
+	}
+	int count = argc > 1 ? atoi(argv[1]) : PARTICLEBENCH_DEFAULT_PARTICLES;
+	int frames = argc > 2 ? atoi(argv[2]) : PARTICLEBENCH_DEFAULT_FRAMES;
+	int width = argc > 3 ? atoi(argv[3]) : 800;
+	int height = argc > 4 ? atoi(argv[4]) : 600;
+	string image = argc > 5 ? argv[5] : "";
+	if (count < 1 || frames < 1 || width < 1 || height < 1) {
+		cerr << "Usage: " << argv[0] << " [--pipelined] [particles] [frames] [width] [height] [image.ppm]" << endl;
+		return 1;
+	}
+
+	ParticleGame game(count, pipelined);
+	vector<Engine::OffscreenFrame> results;
+	game.RunOffscreen(width, height, frames, PARTICLEBENCH_DELTA, 0, results, image);
+	if (results.empty()) {
+		cerr << "No frames were measured" << endl;
+		return 1;
+	}
+
+	vector<float> total;
+	unsigned long long drawCalls = 0;
+	for (const Engine::OffscreenFrame& frame : results) {
+		total.push_back(frame.cpuMs + frame.finishMs);
+		drawCalls += frame.counters.drawCalls;
+	}
+	sort(total.begin(), total.end());
+	size_t overBudget = total.end() - upper_bound(total.begin(), total.end(), PARTICLEBENCH_BUDGET);
+	double sum = 0;
+	for (float ms : total) {
+		sum += ms;
+	}
+	cout << count << " particles, " << results.size() << " frames at " << width << "x" << height << (pipelined ? ", pipelined" : "") << endl;
+	cout << "frame ms: " << sum / total.size() << " mean, " << total[total.size() / 2] << " p50, "
+		<< total[(size_t)(0.99f * (total.size() - 1))] << " p99, " << total.back() << " max" << endl;
+	cout << "draw calls per frame: " << (double)drawCalls / results.size() << endl;
+	cout << overBudget << " frames over the " << PARTICLEBENCH_BUDGET << " ms budget" << endl;
+	return overBudget > results.size() / 100 ? 1 : 0;
+}
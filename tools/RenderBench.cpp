@@ -0,0 +1,74 @@
+// Renders the menu into an offscreen framebuffer for a number of frames and
+// reports CPU time, draw calls, state changes and uploads per frame. Runs on
+// Mesa llvmpipe through EGL surfaceless (or OSMesa), no window or GPU needed.
+// The last frame can be written out to diff against a reference image.
+// Needs src/Offscreen.cpp and src/OffscreenRunner.cpp on top of the engine.
+//
+// Usage: RenderBench [frames] [width] [height] [image.ppm]
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+#include "Menu.h"
+
+using namespace std;
+
+#define RENDERBENCH_DEFAULT_FRAMES 600
+// Real time for the workers to decode the buttons and the font before measuring
+#define RENDERBENCH_WARMUP 1000.0f
+#define RENDERBENCH_DELTA (1000.0f / 60.0f)
+
+// p-th percentile of values, sorts them
+static float Percentile(vector<float>& values, float p)
+{
+	sort(values.begin(), values.end());
+	return values[(size_t)(p * (values.size() - 1))];
+}
+
+static void Report(const char* name, vector<float> values)
+{
+	double sum = 0;
+	for (float value : values) {
+		sum += value;
+	}
+	cout << name << ": " << sum / values.size() << " mean, " << Percentile(values, 0.5f) << " p50, "
+		<< Percentile(values, 0.99f) << " p99, " << values.back() << " max" << endl;
+}
+
+int main(int argc, char** argv)
+{
+	int frames = argc > 1 ? atoi(argv[1]) : RENDERBENCH_DEFAULT_FRAMES;
+	int width = argc > 2 ? atoi(argv[2]) : 800;
+	int height = argc > 3 ? atoi(argv[3]) : 600;
+	string image = argc > 4 ? argv[4] : "";
+	if (frames < 1 || width < 1 || height < 1) {
+		cerr << "Usage: " << argv[0] << " [frames] [width] [height] [image.ppm]" << endl;
+		return 1;
+	}
+
+	Menu menu;
+	vector<Engine::OffscreenFrame> results;
+	menu.RunOffscreen(width, height, frames, RENDERBENCH_DELTA, RENDERBENCH_WARMUP, results, image);
+	if (results.empty()) {
+		cerr << "No frames were measured" << endl;
+		return 1;
+	}
+
+	vector<float> cpu, finish, drawCalls, stateChanges, uploads;
+	for (const Engine::OffscreenFrame& frame : results) {
+		cpu.push_back(frame.cpuMs);
+		finish.push_back(frame.finishMs);
+		drawCalls.push_back((float)frame.counters.drawCalls);
+		stateChanges.push_back((float)frame.counters.stateChanges);
+		uploads.push_back((float)frame.counters.uploadBytes);
+	}
+	cout << results.size() << " frames at " << width << "x" << height << endl;
+	Report("cpu ms", cpu);
+	Report("finish ms", finish);
+	Report("draw calls", drawCalls);
+	Report("state changes", stateChanges);
+	Report("upload bytes", uploads);
+	return 0;
+}
@@ -0,0 +1,127 @@
+// Records frames of random deltas and input with InputRecorder, plays the log
+// back with InputReplay and checks that every delta, event and the seed come
+// back exactly, with nothing left over. Exits with 1 on the first difference.
+//
+// Usage: ReplayCheck [frames] [file]
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+
+#include "Replay.h"
+#include "Random.h"
+
+using namespace std;
+
+#define REPLAYCHECK_DEFAULT_FRAMES 100000
+#define REPLAYCHECK_SEED 0x5EEDF00DULL
+// Most frames in a session have no input at all
+#define REPLAYCHECK_MAX_EVENTS 6
+
+// Deltas around 60 FPS plus the odd hitch, keys from small SDL codes to large
+// scancode masks, mouse coordinates past either edge of the window
+static void MakeFrame(Engine::Random& random, float& deltaTime, vector<Engine::InputEvent>& events)
+{
+	deltaTime = random.NextInt(100) == 0 ? 250.0f * random.NextFloat() : 16.0f + random.NextFloat();
+	events.clear();
+	unsigned int count = random.NextInt(4) == 0 ? random.NextInt(REPLAYCHECK_MAX_EVENTS + 1) : 0;
+	for (unsigned int i = 0; i < count; i++) {
+		Engine::InputEvent event = {};
+		event.type = (Engine::InputEventType)random.NextInt(3);
+		if (event.type == Engine::INPUT_MOUSE) {
+			event.x = (int)random.NextInt(8192) - 4096;
+			event.y = (int)random.NextInt(8192) - 4096;
+		}
+		else {
+			event.key = random.NextInt(2) == 0 ? random.NextInt(512) : (uint32_t)random.Next();
+		}
+		events.push_back(event);
+	}
+}
+
+static bool SameEvent(const Engine::InputEvent& a, const Engine::InputEvent& b)
+{
+	if (a.type != b.type) {
+		return false;
+	}
+	// Only the fields the log stores for the type
+	if (a.type == Engine::INPUT_MOUSE) {
+		return a.x == b.x && a.y == b.y;
+	}
+	return a.key == b.key;
+}
+
+int main(int argc, char** argv)
+{
+	int frames = argc > 1 ? atoi(argv[1]) : REPLAYCHECK_DEFAULT_FRAMES;
+	string path = argc > 2 ? argv[2] : "replaycheck.bin";
+	if (frames < 1) {
+		cerr << "Usage: " << argv[0] << " [frames] [file]" << endl;
+		return 1;
+	}
+
+	Engine::InputRecorder recorder;
+	if (!recorder.Open(path, REPLAYCHECK_SEED)) {
+		cerr << "Unable to write " << path << endl;
+		return 1;
+	}
+	Engine::Random random(1);
+	float deltaTime;
+	vector<Engine::InputEvent> events;
+	unsigned long long recordedEvents = 0;
+	for (int i = 0; i < frames; i++) {
+		MakeFrame(random, deltaTime, events);
+		recorder.BeginFrame(deltaTime);
+		for (const Engine::InputEvent& event : events) {
+			recorder.Record(event);
+		}
+		recordedEvents += events.size();
+	}
+	recorder.Close();
+
+	Engine::InputReplay replay;
+	if (!replay.Open(path)) {
+		cerr << "Unable to read " << path << " back" << endl;
+		return 1;
+	}
+	if (replay.GetSeed() != REPLAYCHECK_SEED) {
+		cerr << "Seed mismatch" << endl;
+		return 1;
+	}
+	// Same stream again for the expected values
+	random.Seed(1);
+	vector<Engine::InputEvent> replayed;
+	for (int i = 0; i < frames; i++) {
+		MakeFrame(random, deltaTime, events);
+		float replayedDelta;
+		replayed.clear();
+		if (!replay.NextFrame(replayedDelta, replayed)) {
+			cerr << "Log ended after " << i << " of " << frames << " frames" << endl;
+			return 1;
+		}
+		if (memcmp(&replayedDelta, &deltaTime, sizeof(float)) != 0) {
+			cerr << "Delta mismatch in frame " << i << endl;
+			return 1;
+		}
+		if (replayed.size() != events.size()) {
+			cerr << "Event count mismatch in frame " << i << endl;
+			return 1;
+		}
+		for (size_t e = 0; e < events.size(); e++) {
+			if (!SameEvent(replayed[e], events[e])) {
+				cerr << "Event mismatch in frame " << i << endl;
+				return 1;
+			}
+		}
+	}
+	if (replay.NextFrame(deltaTime, replayed)) {
+		cerr << "Log has frames past the recording" << endl;
+		return 1;
+	}
+	replay.Close();
+	remove(path.c_str());
+
+	cout << frames << " frames and " << recordedEvents << " events replayed exactly" << endl;
+	return 0;
+}
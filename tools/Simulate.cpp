@@ -0,0 +1,123 @@
+// Monte-Carlo runs of the match-3 rules without a window. Every game plays a
+// random legal swap per update, headless and in parallel on the thread pool,
+// and the clears per game are summarised for balancing levels and scoring.
+//
+// Usage: Simulate [games] [moves] [colours] [width] [height]
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+#include "Game.h"
+#include "Board.h"
+#include "Cascade.h"
+#include "Moves.h"
+
+using namespace std;
+
+#define SIMULATE_DEFAULT_GAMES 100000
+#define SIMULATE_DEFAULT_MOVES 30
+// Update delta handed to the games, one move per update
+#define SIMULATE_DELTA (1000.0f / 60.0f)
+
+class SimulatedGame :
+	public Engine::Game
+{
+public:
+	SimulatedGame(uint64_t seed, int width, int height, int colours) : random(seed), board(width, height, colours) {}
+	unsigned int GetCleared() const { return cleared; }
+	unsigned int GetDeadlocks() const { return deadlocks; }
+
+protected:
+	virtual void Init() {}
+	virtual void DeInit() {}
+	virtual void Render() {}
+	virtual bool InitHeadless()
+	{
+		Fill();
+		return true;
+	}
+	virtual void Update(float deltaTime)
+	{
+		Engine::Move move;
+		if (!Engine::MoveGenerator::Hint(board, random, move)) {
+			deadlocks++;
+			Fill();
+			return;
+		}
+		int x2 = move.vertical ? move.x : move.x + 1;
+		int y2 = move.vertical ? move.y + 1 : move.y;
+		board.Swap(move.x, move.y, x2, y2);
+		resolver.ResolveSwap(board, random, move.x, move.y, x2, y2);
+		cleared += resolver.GetClearedCount();
+	}
+
+private:
+	void Fill()
+	{
+		for (int y = 0; y < board.GetHeight(); y++) {
+			for (int x = 0; x < board.GetWidth(); x++) {
+				board.Set(x, y, (uint8_t)random.NextInt(board.GetColourCount()));
+			}
+		}
+		resolver.ResolveAll(board, random);
+	}
+	Engine::Random random;
+	Engine::Board board;
+	Engine::CascadeResolver resolver;
+	unsigned int cleared = 0, deadlocks = 0;
+};
+
+int main(int argc, char** argv)
+{
+	int games = argc > 1 ? atoi(argv[1]) : SIMULATE_DEFAULT_GAMES;
+	int moves = argc > 2 ? atoi(argv[2]) : SIMULATE_DEFAULT_MOVES;
+	int colours = argc > 3 ? atoi(argv[3]) : BOARD_DEFAULT_COLOURS;
+	int width = argc > 4 ? atoi(argv[4]) : BOARD_DEFAULT_WIDTH;
+	int height = argc > 5 ? atoi(argv[5]) : BOARD_DEFAULT_HEIGHT;
+	if (games < 1 || moves < 1 || colours < 3 || colours > BOARD_MAX_COLOURS || width < 3 || width > BOARD_MAX_WIDTH || height < 3 || height > BOARD_MAX_HEIGHT) {
+		cerr << "Usage: " << argv[0] << " [games] [moves] [colours 3-" << BOARD_MAX_COLOURS << "] [width 3-" << BOARD_MAX_WIDTH
+			<< "] [height 3-" << BOARD_MAX_HEIGHT << "]" << endl;
+		return 1;
+	}
+
+	// Every game writes only its own slot
+	vector<unsigned int> cleared(games), deadlocks(games);
+	auto start = chrono::steady_clock::now();
+	unsigned int failed = Engine::Game::RunHeadlessBatch(games, moves, SIMULATE_DELTA,
+		[width, height, colours](unsigned int index) {
+			return unique_ptr<Engine::Game>(new SimulatedGame(index + 1, width, height, colours));
+		},
+		[&cleared, &deadlocks](unsigned int index, Engine::Game& game) {
+			SimulatedGame& simulated = static_cast<SimulatedGame&>(game);
+			cleared[index] = simulated.GetCleared();
+			deadlocks[index] = simulated.GetDeadlocks();
+		});
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	if (failed > 0) {
+		cerr << failed << " games failed to start" << endl;
+		return 1;
+	}
+
+	double mean = 0, m2 = 0;
+	unsigned long long totalDeadlocks = 0;
+	unsigned int lowest = cleared[0], highest = cleared[0];
+	for (int i = 0; i < games; i++) {
+		// Welford, like the frame time statistics
+		double delta = cleared[i] - mean;
+		mean += delta / (i + 1);
+		m2 += delta * (cleared[i] - mean);
+		lowest = cleared[i] < lowest ? cleared[i] : lowest;
+		highest = cleared[i] > highest ? cleared[i] : highest;
+		totalDeadlocks += deadlocks[i];
+	}
+	cout << games << " games of " << moves << " moves, " << width << "x" << height << ", " << colours << " colours" << endl;
+	cout << "cleared per game: " << mean << " mean, " << (games > 1 ? sqrt(m2 / (games - 1)) : 0.0) << " stddev, "
+		<< lowest << " min, " << highest << " max" << endl;
+	cout << "deadlocks: " << (double)totalDeadlocks / games << " per game" << endl;
+	cout << games / seconds << " games/s, " << (double)games * moves / seconds << " updates/s on "
+		<< Engine::ThreadPool::GetDefault().GetWorkerCount() << " workers" << endl;
+	return 0;
+}